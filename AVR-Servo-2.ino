@@ -5,6 +5,27 @@
 // History:   2022/07/12 AP Version 2.0
 //            2025/02/16 AP Version 2.1
 //            2025/06/01 AP Version 2.2 - First production version
+//            2026/10/16 agent: optional timing of the main loop (see timing.h)
+//            2026/10/16 agent: servo CVs are read from a RAM copy
+//            2026/10/16 agent: setup() does not wait for the servo start-up phase
+//            2026/10/16 agent: buttons use getRequestedPosition()
+//            2026/10/16 agent: routes (see routes.h)
+//            2026/10/16 agent: a new EEPROM layout version keeps the servo CVs and curves
+//            2026/10/16 agent: servo loops and buttons are driven by NUMBER_OF_SERVOS
+//            2026/10/16 agent: timing of every stage of the main loop
+//            2026/10/16 agent: idle sleep if the main loop has nothing to do
+//            2026/10/16 agent: changed positions are written from loop()
+//            2026/10/16 agent: queued EEPROM writes (see eeprom_writer.h)
+//            2026/10/16 agent: curve library commands via PoM / SM
+//            2026/10/16 agent: binary configuration protocol (see config_protocol.h)
+//            2026/10/16 agent: accessory commands are dispatched via a turnout map
+//            2026/10/16 agent: servos may have an accessory address of their own
+//            2026/10/16 agent: extended accessory (signal aspect) commands
+//            2026/10/16 agent: messages via the non-blocking logger
+//            2026/10/16 agent: changed servo CVs are applied without a reboot
+//            2026/10/16 agent: "moving" feedback and feedback on arrival
+//            2026/10/16 agent: PoM reads of the timing results
+//            2026/10/16 agent: queued EEPROM writes are flushed before a PoM / SM command
 //
 // Purpose:   DCC Servo decoder for the first AVR Servo board, with two servo connections
 //
@@ -14,13 +35,22 @@
 //
 // ******************************************************************************************************
 #include <Arduino.h>              // For general definitions
+#include <avr/sleep.h>            // For idle sleep
 #include <AP_DCC_Decoder_Core.h>  // To include all objects, such as dcc, accCmd, etc.
+#include <EEPROM.h>               // To check for CVs that are still queued for EEPROM
 #include "hardware.h"             // The pin and EEPROM specific details
 #include "servo_CVs.h"            // Servo specific CVs
 #include "servo_position.h"       // Storage for the servo positions in EEPROM
 #include "myServo.h"              // Inherits and extends the ServoMoba class
 #include "myRSBus.h"              // Perfroms all RS-Bus feedback functions
 #include "configure.h"            // Allows configuration via the hand held
+#include "routes.h"               // Routes: one accessory command moves several servos
+#include "servo_addresses.h"      // Servos with an accessory address of their own
+#include "eeprom_writer.h"        // Queued, non-blocking EEPROM writes
+#include "curve_library.h"        // Library of user curves in flash
+#include "config_protocol.h"      // Binary configuration protocol over the serial monitor
+#include "logger.h"               // Non-blocking messages on the serial monitor
+#include "timing.h"               // Optional measurement of execution times (see timing.h)
 
 #define SKETCH_VERSION 2.2
 
@@ -30,8 +60,11 @@ MyRsBus rsbus;                    // MyRsBus inherits RSbusConnection, and is us
 BasicLed configLed;               // Instantiate the extra green LED to show configuration mode
 
 
-ToggleButton buttonPos0;
-ToggleButton buttonPos1;
+ToggleButton button[NUMBER_OF_BUTTONS]; // Button i toggles the position of servo i
+
+#define TURNOUTS_PER_ADDRESS  4           // An accessory decoder address has four turnouts
+uint8_t turnoutMap[TURNOUTS_PER_ADDRESS]; // Turnout (1..4) - 1 => servo number (see initTurnoutMap())
+uint8_t servoFeedback[NUMBER_OF_SERVOS];  // Servo number => RS-Bus feedback slot (Feedback_t)
 
 
 Configure handheldConfig;         // object that takes care of configuration via the hand held
@@ -46,17 +79,32 @@ void setup() {
   delay(100);
   Monitor.begin(115200);
   delay(100);
-  Monitor.println();
-  Monitor.println("Servo2Decoder");
-  Monitor.print("Version: "); Monitor.println(SKETCH_VERSION);
+  LOG_INFOLN();
+  LOG_INFOLN("Servo2Decoder");
+  LOG_INFO("Version: "); LOG_INFOLN(SKETCH_VERSION);
 
   // Step 2: If the EEPROM has not yet been initialised, initialise the SERVO SPECIFIC values.
   // This involves all EEPROM values from index 65 and higher, and includes three parts:
   // 1) servo specific CVs (65..128/192),
   // 2) the (2 or 4) curves that are stored in EEPROM
   // 3) the circular buffer, which holds the last positions
+  // If the EEPROM has the layout of another software version, but for the same number of servos, the 
+  // servo CVs and curves are kept and only the other parts are initialised (see hardware.h).
+  uint8_t layout = cvValues.read(INDEX_EEPROM_LAYOUT);
   if (cvValues.notInitialised()) CreateDefaultServoValuesInEEPROM();
+  else if ((layout & 0x0F) != NUMBER_OF_SERVOS) {
+    LOG_INFOLN("Number of servos changed: servo CVs, curves and routes are initialised");
+    CreateDefaultServoValuesInEEPROM();
+  }
+  else if (layout != EEPROM_LAYOUT) {
+    LOG_INFOLN("EEPROM layout changed: routes and intermediate positions are initialised");
+    UpgradeServoValuesInEEPROM();
+  }
   // CreateDefaultServoValuesInEEPROM();     // May be used to temporarily reinitialise the EEPROM
+  // From now on the servo specific CVs are read from a copy in RAM (see servo_CVs.cpp)
+  LoadServoCVs();
+  routes.init();
+  servoAddresses.init();
   //
   // Step 3: Set the default CV values (1..64; see AP_CV_values.h. for details)
   // Decoder type (DecType) and software version (version) are set using cvValues.init().
@@ -75,26 +123,28 @@ void setup() {
   // Skipping uneven (or even) addresses avoids potential problems with RS-Bus switch feedback 
   // See: https://github.com/aikopras/RSbus/blob/master/extras/switch-feedback-problems.md
   skipUnEven = cvValues.read(skipUnEven);
+  initTurnoutMap();
   //
   // Step 5: Attach the extra (green) LED, which we will use to signal we are in configuration mode
   configLed.attach(LED_CONFIG);
   //
   // Step 6: Initialse the servos
   // The main part of this sketch is responsible for the servo initialisation and movement
-  // See myServo for details
-  servo[0].init(0);
-  servo[1].init(1);
+  // See myServo for details. init() does not wait for the start-up phase of the servo to complete;
+  // the remaining initialisation is done by checkServo(), which is called from loop(). 
+  for (uint8_t i = 0; i < NUMBER_OF_SERVOS; i++) servo[i].init(i);
+  storedPositions.initPowerFailDetection();
   //
   // Step 7: Initialise the object for RS-Bus feedback messages. The address is taken from
   // the myRSAddr CV. We need skipUnEven to determine of each servo has its own feedback nibble,
   // or if two servos share the same RS-Bus nibble.
   rsbus.init(cvValues.read(myRSAddr), skipUnEven);
   //
-  // Step 8: Connect the two buttons that can be used to change the servo's position
-  buttonPos0.attach(POSITION0_PIN, DEBOUNCE_TIME);
-  buttonPos1.attach(POSITION1_PIN, DEBOUNCE_TIME);
+  // Step 8: Connect the buttons that can be used to change the servo's position
+  for (uint8_t i = 0; i < NUMBER_OF_BUTTONS; i++) button[i].attach(positionPins[i], DEBOUNCE_TIME);
   //
   printAddresses();
+  logger.flush();                 // From now on, the logger never waits for the serial port
 }
 
 
@@ -102,67 +152,59 @@ void setup() {
 //
 //******************************************************************************************************
 void loop() {
+  TIMING_START(loopStart);
+  TIMING_START(dispatchStart);
   // Step1: Check if we are in normal mode or configuration mode
   if (!configMode) {    // We are in normal mode for servo operation
     if (dcc.input()) {  // Any DCC command received?
       switch (dcc.cmdType) {
         case Dcc::MyAccessoryCmd:
           onBoardLed.activity();
+          // Extended accessory (signal aspect) commands select one of the servo positions
+          if (accCmd.command == Accessory::extendedAccessory) {
+            setServoAspect();
+            break;
+          }
+          // Check first if this command starts a route. If so, the route takes care of the servos.
+          // A servo may also have this address as its own address (see servo_addresses.h)
+          if (accCmd.activate && routes.start(accCmd.outputAddress, accCmd.position)) break;
+          if (accCmd.activate && setAddressedServo()) break;
           // printAccessoryDetails();  // for debugging
-          // If skipUnEven is true, turnout 1 and turnout 2 will be used for servo[0]
-          // whereas turnout 3 and turnout 4 are for servo[1]
-          // If skipUnEven is false, turnout 1 is for servo[0] and turnout 2 for servo[1]
-          // In that case, turnout 3 and 4 will not be used.
-          if ((accCmd.activate) && skipUnEven) {
-            switch (accCmd.turnout) {
-              case 1:
-                servo[0].set(accCmd.position);
-                rsbus.sendNibble0(accCmd.position);
-                break;
-              case 2:
-                servo[0].set(accCmd.position);
-                rsbus.sendNibble0(accCmd.position);
-                break;
-              case 3:
-                servo[1].set(accCmd.position);
-                rsbus.sendNibble1(accCmd.position);
-                break;
-              case 4:
-                servo[1].set(accCmd.position);
-                rsbus.sendNibble1(accCmd.position);
-                break;
-            };
-          } else {  // skipUnEven = false
-            switch (accCmd.turnout) {
-              case 1:
-                servo[0].set(accCmd.position);
-                rsbus.sendFB01(accCmd.position);
-                rsbus.send4bits(LowBits, rsbus.feedbackNibble0);
-                break;
-              case 2:
-                servo[1].set(accCmd.position);
-                rsbus.sendFB23(accCmd.position);
-                rsbus.send4bits(LowBits, rsbus.feedbackNibble0);
-                break;
-              case 3: break;  // Might be used for servo-3 => sendFB45(position)
-              case 4: break;  // Might be used for servo-4 => sendFB67(position)
-            };
+          // The turnout (1..4) determines the servo and its feedback slot (see initTurnoutMap())
+          // If skipUnEven, a servo reacts to activate commands only.
+          if (skipUnEven && !accCmd.activate) break;
+          if ((accCmd.turnout >= 1) && (accCmd.turnout <= TURNOUTS_PER_ADDRESS)) {
+            uint8_t servoNumber = turnoutMap[accCmd.turnout - 1];
+            if (servoNumber != NO_SERVO) setServo(servoNumber, accCmd.position);
           }
           break;  // Dcc::MyAccessoryCmd
 
+        case Dcc::AnyAccessoryCmd:
+          // Accessory commands for other decoders may start a route as well,
+          // and servos may have an accessory address of their own
+          if (accCmd.command == Accessory::extendedAccessory) {
+            setServoAspect();
+            break;
+          }
+          if (accCmd.activate) {
+            if (routes.start(accCmd.outputAddress, accCmd.position)) break;
+            setAddressedServo();
+          }
+          break;
+
         case Dcc::MyPomCmd:
           // Note: I have a problem in my Programmer Decoder PoM: My maximum CV number is 8 (instead of 10) bits
-          cvProgramming.processMessage(Dcc::MyPomCmd);
-          Monitor.print("PoM Command. ");
-          Monitor.print("Received CV Number: ");
-          Monitor.print(cvCmd.number);
-          //Monitor.print(" - Received CV Value: ");
-          //Monitor.print(cvCmd.value);
-          Monitor.println();
+          handleCvCommand(Dcc::MyPomCmd);
+          LOG_INFO("PoM Command. ");
+          LOG_INFO("Received CV Number: ");
+          LOG_INFO(cvCmd.number);
+          //LOG_INFO(" - Received CV Value: ");
+          //LOG_INFO(cvCmd.value);
+          LOG_INFOLN();
           break;
 
         case Dcc::SmCmd:
-          cvProgramming.processMessage(Dcc::SmCmd);
+          handleCvCommand(Dcc::SmCmd);
           break;
 
         case Dcc::MyLocoF9F12Cmd:
@@ -188,78 +230,250 @@ void loop() {
     configMode = handheldConfig.checkConfig();  // Should be called as frequent as possible
     };    // end of DCC input
   };      // end of config mode
+  TIMING_STOP(DccDispatch, dispatchStart);
   //
   // Step 2: as frequent as possible update the RS-Bus hardware, check if the programming
   // button is pushed, and if the status of the onboard LED should be changed.
+  TIMING_START(updateStart);
   decoderHardware.update();
+  TIMING_STOP(DecoderUpdate, updateStart);
   //
   // Step 3: as frequent as possible check if a RSBus feedback message should be send.
+  TIMING_START(feedbackStart);
   rsbus.checkRSFeedback();
+  TIMING_STOP(RsFeedback, feedbackStart);
+  //
+  // Step 3a: check if the next step of a running route should be executed
+  TIMING_START(routeStart);
+  routes.check();
+  TIMING_STOP(RouteCheck, routeStart);
+  //
+  // Step 3b: check if changed servo positions should be written to EEPROM (see servo_position.h),
+  // and start the write of the next queued EEPROM byte, if the EEPROM is ready (see eeprom_writer.h)
+  storedPositions.check();
+  eepromWriter.update();
+  //
+  // Step 3c: check if a request has been received via the binary configuration protocol
+  configProtocol.update();
   //
-  // Step 4: as frequent as possible check if one or more servos require updates
-  servo[0].checkServo();
-  servo[1].checkServo();
+  // Step 4: as frequent as possible check if a servo requires updates
+  // The servos are checked round-robin: one servo per loop, to keep the duration of a loop short
+  // and independent of the number of servos.
+  static uint8_t nextServo = 0;
+  TIMING_START(checkStart);
+  servo[nextServo].checkServo();
+  TIMING_STOP(CheckServo + nextServo, checkStart);
+  #if MOTION_FEEDBACK
+    // Report the new position once the servo has arrived there (see myRSBus.h)
+    if (servo[nextServo].arrived())
+      rsbus.sendFeedback(servoFeedback[nextServo], servo[nextServo].getPosition());
+  #endif
+  nextServo++;
+  if (nextServo == NUMBER_OF_SERVOS) nextServo = 0;
   //
   // Step 5: Check the buttons if switch positions should be changed
   // This is implemented on board V2.0 (2022/07), but will be removed on futire boards
-  buttonPos0.read();
-  if (buttonPos0.changed()) {
-    bool newPos = !servo[0].getPosition();
-    servo[0].set(newPos);
-    if (skipUnEven) rsbus.sendNibble0(newPos);
-    else {
-      rsbus.sendFB01(newPos);
-      rsbus.send4bits(LowBits, rsbus.feedbackNibble0);      
-    }
-  };
-  buttonPos1.read();
-  if (buttonPos1.changed()) {
-    bool newPos = !servo[1].getPosition();
-    servo[1].set(newPos);
-    if (skipUnEven) rsbus.sendNibble1(newPos);
-    else {
-      rsbus.sendFB23(newPos);
-      rsbus.send4bits(LowBits, rsbus.feedbackNibble0);  
-    }  
+  TIMING_START(buttonStart);
+  for (uint8_t i = 0; i < NUMBER_OF_BUTTONS; i++) {
+    button[i].read();
+    if (button[i].changed()) setServo(i, !servo[i].getRequestedPosition());
   };
+  TIMING_STOP(Buttons, buttonStart);
   // 
+  // Step 5a: Send queued log messages, as far as this can be done without waiting
+  logger.update();
+  //
+  // Step 6: If enabled, measure the duration of this loop and (regularly) report all timing results
+  TIMING_STOP(LoopIteration, loopStart);
+  TIMING_REPORT();
+  //
+  // Step 7: If there is nothing to do, sleep until the next interrupt
+  #if IDLE_SLEEP
+    if (decoderIsIdle()) {
+      set_sleep_mode(SLEEP_MODE_IDLE);
+      sleep_mode();
+    }
+  #endif
 };
 
 
+//******************************************************************************************************
+// Returns true if the main loop has nothing to do until the next interrupt.
+// All events the decoder reacts upon are signalled by an interrupt: the DCC and RS-Bus interrupts,
+// the servo pulse (TCA) interrupts and the millis() timer interrupt, which occurs every millisecond
+// and ensures that buttons, LEDs and all timeouts are still checked. If an interrupt occurs just
+// after decoderIsIdle() has been called, the processor sleeps until the next interrupt. This adds at
+// most one millisecond delay.
+//******************************************************************************************************
+bool decoderIsIdle() {
+  if (configMode) return false;
+  if (routes.running) return false;
+  if (!eepromWriter.idle()) return false;
+  for (uint8_t i = 0; i < NUMBER_OF_SERVOS; i++) 
+    if (!servo[i].idle()) return false;
+  return true;
+}
+
+
+//******************************************************************************************************
+// Builds the tables that map a turnout (1..4) of our accessory address to a servo, and a servo to
+// its RS-Bus feedback slot. Should be called once skipUnEven is known.
+// If skipUnEven is true, turnout 1 and turnout 2 are used for servo[0], whereas turnout 3 and 
+// turnout 4 are for servo[1]. Each of these servos has its own feedback nibble.
+// If skipUnEven is false, turnout 1 is for servo[0], turnout 2 for servo[1], turnout 3 for servo[2]
+// and turnout 4 for servo[3] (if these servos exist on this board). Each servo uses two feedback bits.
+// Servos without an RS-Bus feedback slot (such as servo[4] and servo[5]) can still be moved via
+// buttons and routes.
+//******************************************************************************************************
+void initTurnoutMap() {
+  for (uint8_t i = 0; i < NUMBER_OF_SERVOS; i++) servoFeedback[i] = FeedbackNone;
+  for (uint8_t turnout = 0; turnout < TURNOUTS_PER_ADDRESS; turnout++) {
+    uint8_t servoNumber;
+    if (skipUnEven) servoNumber = turnout / 2;
+      else servoNumber = turnout;
+    if (servoNumber >= NUMBER_OF_SERVOS) servoNumber = NO_SERVO;
+    turnoutMap[turnout] = servoNumber;
+  }
+  if (skipUnEven) {
+    const uint8_t nibbles[2] = {FeedbackNibble0, FeedbackNibble1};
+    for (uint8_t i = 0; (i < 2) && (i < NUMBER_OF_SERVOS); i++) servoFeedback[i] = nibbles[i];
+  }
+  else {
+    const uint8_t pairs[4] = {FeedbackFB01, FeedbackFB23, FeedbackFB45, FeedbackFB67};
+    for (uint8_t i = 0; (i < 4) && (i < NUMBER_OF_SERVOS); i++) servoFeedback[i] = pairs[i];
+  }
+}
+
+
+//******************************************************************************************************
+// If a servo has the address of the received accessory command as its own address, that servo is
+// moved. Returns true if such servo exists. For most accessory commands a single bit test is needed.
+//******************************************************************************************************
+bool setAddressedServo() {
+  uint8_t servoNumber = servoAddresses.find(accCmd.outputAddress);
+  if (servoNumber == NO_SERVO) return false;
+  setServo(servoNumber, accCmd.position);
+  return true;
+}
+
+
+//******************************************************************************************************
+// Handles an RCN-213 extended accessory (signal aspect) command. The servo is found via its own address
+// or, for our own decoder address, via the turnout map. Aspect 0 and 1 are the normal end positions
+// (including RS-Bus feedback); higher aspects select an intermediate position (see myServo.h).
+// The accCmd fields are those of the Accessory class of AP_DCC_library (src/AP_DCC_library.h), on which
+// AP_DCC_Decoder_Core is built. For an extended accessory command, accCmd.command is set to 
+// Accessory::extendedAccessory, accCmd.signalHead holds the address (1..2048, numbered as the switch 
+// addresses of basic accessory commands) and accCmd.signalAspect the aspect (0..255). Fields such as
+// accCmd.outputAddress and accCmd.turnout are only filled in for basic accessory commands. Therefore
+// the turnout is derived from the signal head address.
+//******************************************************************************************************
+void setServoAspect() {
+  uint16_t address = accCmd.signalHead;
+  if ((address == 0) || (address > MAX_SWITCH_ADDRESS)) return;
+  uint8_t servoNumber = servoAddresses.find(address);
+  if ((servoNumber == NO_SERVO) && (dcc.cmdType == Dcc::MyAccessoryCmd))
+    servoNumber = turnoutMap[(address - 1) % TURNOUTS_PER_ADDRESS];
+  if (servoNumber == NO_SERVO) return;
+  uint8_t aspect = accCmd.signalAspect;
+  if (aspect < 2) setServo(servoNumber, aspect);
+    else servo[servoNumber].setAspect(aspect);
+}
+
+
+//******************************************************************************************************
+// Handles a PoM or SM command. Writes to the command CVs of the curve library are handled by that
+// library. If TIMING_ENABLED, the read-only CVs with the timing results are handled by timing.cvCommand().
+// All other commands are handled by the AP_DCC_Decoder_Core library. If that changed the value
+// of a CV, the RAM copies of the CVs are updated, and the servo uses the new value without a reboot.
+// Command stations repeat PoM commands, and verify (read) commands do not change anything. Therefore
+// the old value is compared with the new value, and nothing happens if the value did not change. 
+// In particular, a servo does not reconfigure its pulse and power signals for every repeated packet.
+//******************************************************************************************************
+void handleCvCommand(Dcc::CmdType_t cmdType) {
+  #if TIMING_ENABLED
+  if (timing.cvCommand(cmdType)) return;     // Read-only CVs with the timing results (see timing.h)
+  #endif
+  if ((cvCmd.operation == CvAccess::writeByte) && curveLibrary.command(cvCmd.number, cvCmd.value)) return;
+  bool inEeprom = (cvCmd.number < EEPROM_SIZE);
+  uint8_t oldValue = 0;
+  if (inEeprom) {
+    oldValue = eepromWriter.read(cvCmd.number);
+    // The library reads and writes the EEPROM directly. If a new value for this CV is still queued (for 
+    // example a treshold that was set via the handheld), the queue is written first. Otherwise the 
+    // queued value would overwrite the PoM / SM value later on, and a read would return the old value.
+    if (oldValue != EEPROM.read(cvCmd.number)) eepromWriter.flush();
+  }
+  cvProgramming.processMessage(cmdType);
+  if (cvCmd.operation == CvAccess::verifyByte) return;
+  if (!inEeprom || (eepromWriter.read(cvCmd.number) == oldValue)) return;
+  ReloadServoCV(cvCmd.number);      // Keep the RAM copy of the servo CVs up to date
+  applyServoCV(cvCmd.number);       // The servo uses the new value without a reboot
+  routes.cvChanged(cvCmd.number);
+  servoAddresses.cvChanged(cvCmd.number);
+  curveLibrary.cvChanged(cvCmd.number);
+}
+
+
+//******************************************************************************************************
+// Should be called after a CV has been changed (and ReloadServoCV() has updated the RAM copy).
+// If the CV belongs to one of the servos, that servo applies its CVs again (see myServo.h).
+//******************************************************************************************************
+void applyServoCV(uint16_t cvNumber) {
+  if ((cvNumber < START_INDEX_SERVO_CVS) || (cvNumber >= START_INDEX_SERVO_CURVES)) return;
+  servo[(cvNumber - START_INDEX_SERVO_CVS) / NUMBER_OF_SERVO_CVS].reloadCVs();
+}
+
+
+//******************************************************************************************************
+// Moves a servo to a new position and sends the RS-Bus feedback for that servo.
+// Used by accessory commands, buttons and routes. If MOTION_FEEDBACK is set, the feedback tells the
+// servo is moving, and the new position is reported by loop() once the servo has arrived.
+//******************************************************************************************************
+void setServo(uint8_t servoNumber, uint8_t position) {
+  servo[servoNumber].set(position);
+  #if MOTION_FEEDBACK
+    rsbus.sendFeedback(servoFeedback[servoNumber], FEEDBACK_MOVING);
+  #else
+    rsbus.sendFeedback(servoFeedback[servoNumber], position);
+  #endif
+}
+
+
 //******************************************************************************************************
 // Some temporary print routines for debugging
 //******************************************************************************************************
 void printCVs() {
   for (uint8_t i = 0; i <= 64; i++) {
-    Monitor.print("CV");
-    Monitor.print(i);
-    Monitor.print(": ");
-    Monitor.println(cvValues.read(i));
+    LOG_DEBUG("CV");
+    LOG_DEBUG(i);
+    LOG_DEBUG(": ");
+    LOG_DEBUGLN(cvValues.read(i));
   }
-  if (cvValues.addressNotSet()) Monitor.println("Address not set");
-  Monitor.print("Decoder Address: ");
-  Monitor.println(cvValues.storedAddress());
-  Monitor.print("RS-Bus Feedback Address: ");
-  Monitor.println(rsbus.address);
+  if (cvValues.addressNotSet()) LOG_DEBUGLN("Address not set");
+  LOG_DEBUG("Decoder Address: ");
+  LOG_DEBUGLN(cvValues.storedAddress());
+  LOG_DEBUG("RS-Bus Feedback Address: ");
+  LOG_DEBUGLN(rsbus.address);
 }
 
 
 void printAccessoryDetails() {
-  Monitor.println("");
-  Monitor.print("Switch address: ");
-  Monitor.print(accCmd.outputAddress);
-  Monitor.print(", Position: ");
-  if (accCmd.position == 1) Monitor.println("+ (1)");
-  else Monitor.println("- (0)");
+  LOG_DEBUGLN("");
+  LOG_DEBUG("Switch address: ");
+  LOG_DEBUG(accCmd.outputAddress);
+  LOG_DEBUG(", Position: ");
+  if (accCmd.position == 1) LOG_DEBUGLN("+ (1)");
+  else LOG_DEBUGLN("- (0)");
 };
 
 void printAddresses() {
-  Monitor.println("");
-  Monitor.print("Decoder adres: ");
-  Monitor.println(cvValues.storedAddress());
-  Monitor.print("RS-Bus adres: ");
-  Monitor.println(cvValues.read(myRSAddr));
-  Monitor.print("Loco adres: ");
-  Monitor.println(cvValues.storedAddress() + 7000);
-  Monitor.println("");
+  LOG_INFOLN("");
+  LOG_INFO("Decoder adres: ");
+  LOG_INFOLN(cvValues.storedAddress());
+  LOG_INFO("RS-Bus adres: ");
+  LOG_INFOLN(cvValues.read(myRSAddr));
+  LOG_INFO("Loco adres: ");
+  LOG_INFOLN(cvValues.storedAddress() + 7000);
+  LOG_INFOLN("");
 }
@@ -0,0 +1,130 @@
+//*****************************************************************************************************
+//
+// File:      config_protocol.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: servo addresses are updated after a write
+//            2026/10/16 agent: changed servo CVs are applied without a reboot
+// 
+// To get a high-level understanding of what this code is supposed to do, see config_protocol.h.
+//
+//******************************************************************************************************
+#include "config_protocol.h"
+#include "eeprom_writer.h"
+#include "servo_CVs.h"
+#include "servo_position.h"
+#include "routes.h"
+#include "servo_addresses.h"
+#include "curve_library.h"
+
+// Changed servo CVs are applied to the servo objects by main
+extern void applyServoCV(uint16_t cvNumber);
+
+// Instantiate the object for the configuration protocol
+ConfigProtocol configProtocol;
+
+// Positions within a frame
+#define CMD         1
+#define LEN         2
+#define ADDR_LOW    3
+#define ADDR_HIGH   4
+#define DATA        5
+
+// Commands
+#define CMD_READ    0x01
+#define CMD_WRITE   0x02
+#define CMD_REPLY   0x80
+#define CMD_ERROR   0xFF
+
+
+uint8_t ConfigProtocol::crc8(uint8_t crc, uint8_t value) {
+  crc ^= value;
+  for (uint8_t i = 0; i < 8; i++) {
+    if (crc & 0x80) crc = (crc << 1) ^ 0x07;
+      else crc = crc << 1;
+  }
+  return crc;
+};
+
+
+void ConfigProtocol::update() {
+  if ((received > 0) && ((millis() - frameStart) > CONFIG_FRAME_TIMEOUT)) received = 0;
+  while (Monitor.available()) {
+    uint8_t value = Monitor.read();
+    if (received == 0) {                                // Wait for the start of a frame
+      if (value != CONFIG_SYNC) continue;
+      frameStart = millis();
+    }
+    frame[received] = value;
+    received++;
+    if (received <= DATA) {
+      if ((received == DATA) && (frame[LEN] > CONFIG_MAX_DATA)) received = 0;  // Invalid length
+      continue;
+    }
+    // A read request has no data; a write request has LEN data bytes. The CRC follows.
+    uint8_t dataBytes = (frame[CMD] == CMD_WRITE) ? frame[LEN] : 0;
+    if (received == DATA + dataBytes + 1) {
+      handleFrame();
+      received = 0;
+      return;                                           // Handle the next frame in the next loop
+    }
+  }
+};
+
+
+void ConfigProtocol::handleFrame() {
+  uint8_t cmd = frame[CMD];
+  uint8_t len = frame[LEN];
+  uint16_t address = frame[ADDR_LOW] + (frame[ADDR_HIGH] << 8);
+  uint8_t dataBytes = (cmd == CMD_WRITE) ? len : 0;
+  // Check the CRC, command and address range
+  uint8_t crc = 0;
+  for (uint8_t i = CMD; i < DATA + dataBytes; i++) crc = crc8(crc, frame[i]);
+  bool valid = (crc == frame[DATA + dataBytes]);
+  valid = valid && (len > 0) && ((address + len) <= EEPROM_SIZE);
+  if (cmd == CMD_WRITE) valid = valid && (address >= START_INDEX_SERVO_CVS);
+    else valid = valid && (cmd == CMD_READ);
+  if (!valid) {
+    sendFrame(CMD_ERROR, 0, false);
+    return;
+  }
+  if (cmd == CMD_READ) {
+    for (uint8_t i = 0; i < len; i++) frame[DATA + i] = eepromWriter.read(address + i);
+    sendFrame(CMD_READ | CMD_REPLY, len, true);
+    return;
+  }
+  // Write. eepromWriter only writes bytes that differ from the EEPROM contents.
+  // Only CVs that get a new value are applied (see handleCvCommand() in the main sketch).
+  bool positionsChanged = false;
+  bool changed[CONFIG_MAX_DATA];
+  for (uint8_t i = 0; i < len; i++) {
+    uint16_t cvNumber = address + i;
+    changed[i] = (eepromWriter.read(cvNumber) != frame[DATA + i]);
+    eepromWriter.write(cvNumber, frame[DATA + i]);
+    if (changed[i] && (cvNumber >= START_INDEX_POSITIONS)) positionsChanged = true;
+  }
+  eepromWriter.flush();                                 // Blocks; RAM copies are reloaded from EEPROM
+  for (uint8_t i = 0; i < len; i++) {
+    if (!changed[i]) continue;
+    uint16_t cvNumber = address + i;
+    ReloadServoCV(cvNumber);
+    applyServoCV(cvNumber);
+    curveLibrary.cvChanged(cvNumber);
+    routes.cvChanged(cvNumber);
+    servoAddresses.cvChanged(cvNumber);
+  }
+  if (positionsChanged) storedPositions.reload();
+  sendFrame(CMD_WRITE | CMD_REPLY, 0, false);
+};
+
+
+void ConfigProtocol::sendFrame(uint8_t cmd, uint8_t len, bool withData) {
+  // The address is still in the frame buffer. For read replies, the data is as well.
+  frame[CMD] = cmd;
+  frame[LEN] = len;
+  uint8_t size = DATA + (withData ? len : 0);
+  uint8_t crc = 0;
+  for (uint8_t i = CMD; i < size; i++) crc = crc8(crc, frame[i]);
+  frame[size] = crc;
+  Monitor.write(frame, size + 1);
+};
@@ -0,0 +1,75 @@
+//*****************************************************************************************************
+//
+// File:      config_protocol.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: servo addresses are updated after a write
+//            2026/10/16 agent: changed servo CVs are applied without a reboot
+// 
+// A compact binary protocol over the serial monitor port, to read and write the servo specific part
+// of the EEPROM (servo CVs, curves, routes and the position buffer) in a few transfers.
+//
+// Setting up a decoder via PoM requires a DCC packet for every single CV: 18 CVs per servo, plus 48
+// bytes per curve and 16 per route. With this protocol, a PC (via an USB-serial adapter) can read the
+// complete configuration of one board, and write it into a batch of other boards, within seconds.
+//
+// Each request and each reply is a frame with the following format:
+//
+// +------+-----+-----+----------+-----------+-------------------+-----+
+// | SYNC | CMD | LEN | ADDR-LOW | ADDR-HIGH | DATA (0..64 bytes) | CRC |
+// +------+-----+-----+----------+-----------+-------------------+-----+
+//
+// - SYNC:  0xA5
+// - CMD:   0x01 = read, 0x02 = write. Replies have bit 7 set (0x81, 0x82). 0xFF = error reply.
+// - LEN:   Read: the number of bytes to read (1..64). Write: the number of data bytes (1..64).
+// - ADDR:  The EEPROM index (= CV number) of the first byte.
+// - DATA:  Write request and read reply only.
+// - CRC:   CRC-8 (polynomial 0x07, initial value 0) over CMD, LEN, ADDR and DATA.
+//
+// A read request is answered by a read reply with the requested bytes. A write request is answered 
+// by a write reply without data, once the data has been written into EEPROM. Only bytes that differ
+// from the current EEPROM contents are written, thus rewriting an unchanged image is fast. While the
+// bytes are written the main loop waits, which is acceptable during provisioning. Reads may address
+// the complete EEPROM; writes are restricted to the servo specific part (START_INDEX_SERVO_CVS and
+// higher), since the general CVs (1..64) are managed by the AP_DCC_Decoder_Core library. A request
+// with an invalid CRC, command or address range is answered by an error reply (CMD = 0xFF, LEN = 0,
+// ADDR as requested). 
+//
+// After a write, the RAM copies of the servo CVs, route triggers and servo addresses are updated.
+// Servos that have decoded a changed curve decode it again before their next move, and changed servo
+// CVs (such as the tresholds) are applied without a reboot. If the position buffer has been written,
+// the newest position record is searched again.
+//
+// Since the serial monitor is also used for (text) debugging output, the PC should ignore all bytes 
+// until it receives a SYNC byte followed by a valid frame. If a frame is not completed within 
+// CONFIG_FRAME_TIMEOUT milliseconds, the decoder discards it. update() should be called from the main
+// loop, and never waits for the serial port.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "hardware.h"
+
+#define CONFIG_SYNC                0xA5
+#define CONFIG_MAX_DATA            64     // Maximum number of data bytes per frame
+#define CONFIG_FRAME_TIMEOUT       100    // Milliseconds
+
+
+class ConfigProtocol {
+  public:
+    void update();                              // Should be called from main as frequent as possible
+
+  private:
+    void handleFrame();                         // Executes a complete (CRC checked) request
+    void sendFrame(uint8_t cmd, uint8_t len, bool withData);
+    uint8_t crc8(uint8_t crc, uint8_t value);   // Adds one byte to the CRC
+
+    uint8_t frame[5 + CONFIG_MAX_DATA + 1];     // The received frame, starting with SYNC
+    uint8_t received;                           // Number of bytes of the frame received so far
+    unsigned long frameStart;                   // Time (in ms) the SYNC byte was received
+};
+
+
+//******************************************************************************************************
+// The object is defined in config_protocol.cpp and may be used by main 
+extern ConfigProtocol configProtocol;
@@ -0,0 +1,89 @@
+//*****************************************************************************************************
+//
+// File:      curve_library.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: messages via the non-blocking logger
+// 
+// To get a high-level understanding of what this code is supposed to do, see curve_library.h.
+//
+// Flash is written using the Flash library of DxCore. Flash can only be erased per page. To store a 
+// single curve, the complete page is therefore copied into RAM, the curve is replaced, the page is 
+// erased and written again.
+//
+//******************************************************************************************************
+#include "curve_library.h"
+#include <Flash.h>                                      // DxCore flash self-programming
+#include "eeprom_writer.h"
+#include "myServo.h"
+#include "logger.h"
+
+extern MyServo servo[NUMBER_OF_SERVOS];                 // Should be instantiated in main()
+
+// Instantiate the object for the curve library
+CurveLibrary curveLibrary;
+
+
+uint32_t CurveLibrary::getAddress(uint8_t curve) {
+  uint8_t page = curve / FLASH_CURVES_PER_PAGE;
+  uint8_t position = curve % FLASH_CURVES_PER_PAGE;
+  return FLASH_CURVES_START + (page * PROGMEM_PAGE_SIZE) + (position * FLASH_CURVE_SIZE);
+};
+
+
+bool CurveLibrary::command(uint16_t cvNumber, uint8_t value) {
+  if ((cvNumber < CURVE_LIBRARY_CV) || (cvNumber >= CURVE_LIBRARY_CV + NUMBER_OF_CURVES)) return false;
+  uint8_t slot = cvNumber - CURVE_LIBRARY_CV;
+  bool result;
+  if (value & 0x80) result = store(slot, value & 0x7F);
+    else result = load(slot, value);
+  LOG_INFO("Curve library: ");
+  LOG_INFO((value & 0x80) ? "store slot " : "load into slot ");
+  LOG_INFO(slot);
+  LOG_INFO(" - curve ");
+  LOG_INFO(value & 0x7F);
+  LOG_INFOLN(result ? " - OK" : " - failed");
+  return true;
+};
+
+
+bool CurveLibrary::load(uint8_t slot, uint8_t curve) {
+  if (curve >= NUMBER_OF_FLASH_CURVES) return false;
+  uint32_t address = getAddress(curve);
+  if (Flash.readByte(address) == 0xFF) return false;    // Empty library curve
+  uint16_t index = START_INDEX_SERVO_CURVES + (slot * 48);
+  for (uint8_t i = 0; i < FLASH_CURVE_SIZE; i++) 
+    eepromWriter.write(index + i, Flash.readByte(address + i));
+  eepromWriter.flush();                                 // The servo library reads EEPROM directly
+  cvChanged(index);
+  return true;
+};
+
+
+bool CurveLibrary::store(uint8_t slot, uint8_t curve) {
+  if (curve >= NUMBER_OF_FLASH_CURVES) return false;
+  if (Flash.checkWritable() != FLASHWRITE_OK) return false;
+  uint32_t address = getAddress(curve);
+  uint32_t pageAddress = address - (address % PROGMEM_PAGE_SIZE);
+  uint16_t offset = address - pageAddress;
+  uint16_t index = START_INDEX_SERVO_CURVES + (slot * 48);
+  // Copy the page into RAM, and replace the curve by the EEPROM curve
+  uint8_t page[PROGMEM_PAGE_SIZE];
+  for (uint16_t i = 0; i < PROGMEM_PAGE_SIZE; i++) page[i] = Flash.readByte(pageAddress + i);
+  for (uint8_t i = 0; i < FLASH_CURVE_SIZE; i++) page[offset + i] = eepromWriter.read(index + i);
+  // Erase and write the page. Flash is written per word
+  if (Flash.erasePage(pageAddress) != FLASHWRITE_OK) return false;
+  for (uint16_t i = 0; i < PROGMEM_PAGE_SIZE; i += 2) {
+    uint16_t word = page[i] + (page[i + 1] << 8);
+    if (word == 0xFFFF) continue;                       // Erased already
+    if (Flash.writeWord(pageAddress + i, word) != FLASHWRITE_OK) return false;
+  };
+  return true;
+};
+
+
+void CurveLibrary::cvChanged(uint16_t cvNumber) {
+  if ((cvNumber < START_INDEX_SERVO_CURVES) || (cvNumber >= START_INDEX_ROUTES)) return;
+  uint8_t slot = (cvNumber - START_INDEX_SERVO_CURVES) / 48;
+  for (uint8_t i = 0; i < NUMBER_OF_SERVOS; i++) servo[i].curveChanged(slot);
+};
@@ -0,0 +1,61 @@
+//*****************************************************************************************************
+//
+// File:      curve_library.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+// 
+// A library of user curves in flash memory.
+//
+// The EEPROM has room for only 2 or 4 user curves of 48 bytes each (see hardware.h). The AVR64DA28
+// has 64K of flash, of which most is unused. Therefore the last FLASH_CURVE_PAGES pages of flash are 
+// reserved for a curve library. Each flash page (512 bytes) holds 10 curves, thus 4 pages hold 40 
+// curves. The format of a library curve is the same as that of an EEPROM curve: pairs of (time, 
+// position) values, ending with (0, 0). An erased library curve (first byte 0xFF) is empty.
+//
+// The Servo-TCA library decodes a curve either from its own PROGMEM table, or from EEPROM. It has no
+// entry point to decode a curve from an arbitrary flash address. Therefore the library curves can not
+// be selected directly by the CurveA / CurveB CVs. Instead, a library curve is copied into one of the 
+// EEPROM curve slots, after which it can be selected as usual (EPROM bit plus INDEX of that slot).
+// Since this copy is only made on request of the user, the number of EEPROM writes remains low, and 
+// loadCurve() decodes the curve at the same speed as before. In the opposite direction, the curve in 
+// an EEPROM slot can be stored in the library, for example after it has been fine-tuned.
+//
+// Both operations are requested by writing (via PoM or SM) to a command CV. These command CVs do not
+// exist in EEPROM; there is one per EEPROM curve slot:
+// CURVE_LIBRARY_CV + slot:  value 0..127:   copy library curve (value) into EEPROM curve slot
+//                           value 128..255: store EEPROM curve slot into library curve (value - 128)
+//
+// Writing into flash requires that flash self-programming is enabled in the DxCore board settings 
+// (see hardware.h). Erasing and writing a flash page halts the processor for several milliseconds, 
+// during which DCC packets are missed. The library should therefore only be written while the layout
+// is being configured. Note that SM commands to the command CVs are not acknowledged.
+//
+// If a curve in EEPROM is changed (via PoM, SM or a library copy), cvChanged() ensures that servos
+// that have decoded the old version of that curve decode it again before their next movement.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "hardware.h"
+
+#define FLASH_CURVE_SIZE           48
+#define FLASH_CURVES_PER_PAGE      (PROGMEM_PAGE_SIZE / FLASH_CURVE_SIZE)
+#define NUMBER_OF_FLASH_CURVES     (FLASH_CURVE_PAGES * FLASH_CURVES_PER_PAGE)
+#define FLASH_CURVES_START         (PROGMEM_SIZE - (FLASH_CURVE_PAGES * PROGMEM_PAGE_SIZE))
+
+
+class CurveLibrary {
+  public:
+    bool command(uint16_t cvNumber, uint8_t value); // Returns true if the CV is a library command CV
+    void cvChanged(uint16_t cvNumber);          // Should be called after a CV is changed via PoM / SM
+
+  private:
+    bool load(uint8_t slot, uint8_t curve);     // Copies a library curve into an EEPROM curve slot
+    bool store(uint8_t slot, uint8_t curve);    // Stores an EEPROM curve slot into the library
+    uint32_t getAddress(uint8_t curve);         // Flash address of a library curve
+};
+
+
+//******************************************************************************************************
+// The object is defined in curve_library.cpp and may be used by main 
+extern CurveLibrary curveLibrary;
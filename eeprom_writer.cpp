@@ -0,0 +1,90 @@
+//*****************************************************************************************************
+//
+// File:      eeprom_writer.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: a rewritten byte moves to the end of the queue
+// 
+// To get a high-level understanding of what this code is supposed to do, see eeprom_writer.h.
+//
+// The queue is a ring buffer. Entry i of the queue is stored at position (first + i) modulo
+// EEPROM_QUEUE_SIZE.
+//
+//******************************************************************************************************
+#include "eeprom_writer.h"
+#include <EEPROM.h>
+
+// Instantiate the object for the EEPROM writes
+EepromWriter eepromWriter;
+
+
+static uint8_t wrap(uint8_t position) {
+  if (position >= EEPROM_QUEUE_SIZE) return position - EEPROM_QUEUE_SIZE;
+  return position;
+};
+
+
+void EepromWriter::write(uint16_t index, uint8_t value) {
+  // If this byte is still queued, remove it. The new value is added at the end of the queue, such that
+  // it is written after all bytes that were queued before it.
+  for (uint8_t i = 0; i < length; i++) {
+    if (queueIndex[wrap(first + i)] == index) {
+      remove(i);
+      break;
+    }
+  }
+  // Nothing to do if the EEPROM holds this value already
+  if (EEPROM.read(index) == value) return;
+  // If the queue is full, we have to wait till the oldest byte has been written
+  if (length == EEPROM_QUEUE_SIZE) writeFirst();
+  uint8_t pos = wrap(first + length);
+  queueIndex[pos] = index;
+  queueValue[pos] = value;
+  length++;
+};
+
+
+uint8_t EepromWriter::read(uint16_t index) {
+  for (uint8_t i = 0; i < length; i++) {
+    uint8_t pos = wrap(first + i);
+    if (queueIndex[pos] == index) return queueValue[pos];
+  }
+  return EEPROM.read(index);
+};
+
+
+void EepromWriter::update() {
+  if (length == 0) return;
+  if (NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm) return;       // Previous write not completed yet
+  writeFirst();
+};
+
+
+void EepromWriter::flush() {
+  while (length > 0) writeFirst();
+};
+
+
+bool EepromWriter::idle() {
+  return (length == 0);
+};
+
+
+void EepromWriter::remove(uint8_t entry) {
+  // Entry i of the queue is removed, by moving all younger entries one position forward
+  for (uint8_t i = entry; i < (length - 1); i++) {
+    uint8_t pos = wrap(first + i);
+    uint8_t next = wrap(first + i + 1);
+    queueIndex[pos] = queueIndex[next];
+    queueValue[pos] = queueValue[next];
+  }
+  length--;
+};
+
+
+void EepromWriter::writeFirst() {
+  // EEPROM.update() waits (only) if a previous write has not completed yet
+  EEPROM.update(queueIndex[first], queueValue[first]);
+  first = wrap(first + 1);
+  length--;
+};
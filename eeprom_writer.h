@@ -0,0 +1,56 @@
+//*****************************************************************************************************
+//
+// File:      eeprom_writer.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: a rewritten byte moves to the end of the queue
+// 
+// Queued, non-blocking writes to EEPROM.
+//
+// Writing a single EEPROM byte on the AVR-DA takes several milliseconds. EEPROM.update() itself
+// returns once the write has been started, but waits until a previous write has completed. Writing
+// several bytes back to back (such as a position record, or a few CVs) therefore blocks the main loop
+// for (number of bytes - 1) times the write time, which gives a visible latency for the next command.
+//
+// Instead of writing directly, the decoder software places the bytes in a small queue, by calling
+// eepromWriter.write(). update(), which is called from the main loop, checks if the NVM controller
+// is ready (EEBUSY flag) and, if so, starts the write of the first byte in the queue. The main loop
+// therefore never waits for the EEPROM.
+//
+// - Bytes are written in the order in which they were queued. This is important for the position
+//   journal, which writes the byte with the phase bit of a record last (see servo_position.h).
+// - If a byte for the same EEPROM index is still queued, that entry is removed and the new value is
+//   added at the end of the queue. The order above therefore also holds for rewritten bytes.
+// - read() returns the queued value, if the byte has not yet been written. Code that reads bytes
+//   that may have been written via the queue should therefore use eepromWriter.read().
+// - If the queue is full, write() falls back to a blocking write of the oldest queued byte.
+// - flush() writes all queued bytes immediately (blocking), for example on power failure.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#define EEPROM_QUEUE_SIZE          16     // Number of bytes that may wait to be written
+
+
+class EepromWriter {
+  public:
+    void write(uint16_t index, uint8_t value);  // Queues the byte. Does not wait for the EEPROM
+    uint8_t read(uint16_t index);               // Returns the queued value, or the EEPROM value
+    void update();                              // Should be called from main as frequent as possible
+    void flush();                               // Writes all queued bytes (blocking)
+    bool idle();                                // true: nothing is waiting to be written
+
+  private:
+    void writeFirst();                          // Writes the oldest byte and removes it from the queue
+    void remove(uint8_t entry);                 // Removes entry (0 = oldest) from the queue
+    uint16_t queueIndex[EEPROM_QUEUE_SIZE];     // EEPROM index of the queued bytes
+    uint8_t queueValue[EEPROM_QUEUE_SIZE];      // Value of the queued bytes
+    uint8_t first;                              // Position in the queue of the oldest byte
+    uint8_t length;                             // Number of bytes in the queue
+};
+
+
+//******************************************************************************************************
+// The object is defined in eeprom_writer.cpp and may be used by all other modules
+extern EepromWriter eepromWriter;
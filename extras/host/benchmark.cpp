@@ -0,0 +1,100 @@
+//*****************************************************************************************************
+//
+// File:      benchmark.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host benchmark for the hot paths of the decoder software (see readme.md, Host build).
+//
+// The execution times are those of the host processor, and the stand-ins for the libraries (such as
+// the Servo-TCA curve decoding) do hardly anything. The numbers are therefore only useful to compare
+// two versions of the decoder software with each other, on the same host. To measure the real
+// execution times, use TIMING_ENABLED on the decoder itself (see timing.h).
+//
+//******************************************************************************************************
+#include <Arduino.h>
+#include <AP_DCC_Decoder_Core.h>
+#include "hardware.h"
+#include "servo_CVs.h"
+#include "servo_position.h"
+#include "myServo.h"
+#include "eeprom_writer.h"
+#include <chrono>
+#include <stdio.h>
+
+// The objects and functions of the main sketch
+void setup();
+void loop();
+extern MyServo servo[NUMBER_OF_SERVOS];
+
+#define ITERATIONS      200000UL
+
+static volatile uint8_t sink;                   // Keeps the compiler from removing the measured code
+
+
+//******************************************************************************************************
+// Calls function ITERATIONS times, and prints the average time per call
+template <typename Function>
+static void measure(const char* name, Function function) {
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < ITERATIONS; i++) function(i);
+  auto stop = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(stop - start).count() / ITERATIONS;
+  printf("%-36s %8.1f ns\n", name, ns);
+}
+
+static void run(unsigned long ms) {
+  for (unsigned long i = 0; i < ms; i++) {
+    hostAdvance(1);
+    loop();
+  }
+}
+
+
+//******************************************************************************************************
+int main() {
+  setup();
+  run(1000);                                    // Start-up phase of the servos
+  printf("%lu iterations per measurement\n", ITERATIONS);
+
+  measure("loop() - idle", [](unsigned long) {
+    loop();
+  });
+
+  measure("checkServo() - idle", [](unsigned long) {
+    servo[0].checkServo();
+  });
+
+  measure("set() - same position", [](unsigned long) {
+    servo[0].set(servo[0].getPosition());
+  });
+
+  measure("loop() - own accessory command", [](unsigned long i) {
+    hostAccessory(1, (i >> 4) & 1, true, true);
+    loop();
+    hostAdvance(1);
+  });
+  run(5000);
+
+  measure("loop() - other accessory command", [](unsigned long i) {
+    hostAccessory(1000, i & 1, true, false);
+    loop();
+  });
+
+  measure("loop() - repeated PoM", [](unsigned long) {
+    hostPom(START_INDEX_SERVO_CVS + Speed, 6, true);
+    loop();
+  });
+
+  measure("saveServoPosition() + check()", [](unsigned long i) {
+    storedPositions.saveServoPosition(0, i & 1);
+    storedPositions.check();
+  });
+
+  measure("eepromWriter.write() + read()", [](unsigned long i) {
+    eepromWriter.write(400 + (i & 7), i);
+    sink = eepromWriter.read(400);
+    if ((i & 15) == 15) eepromWriter.flush();
+  });
+  return 0;
+}
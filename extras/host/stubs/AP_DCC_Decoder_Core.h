@@ -0,0 +1,139 @@
+//*****************************************************************************************************
+//
+// File:      AP_DCC_Decoder_Core.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host stand-in for the objects of the AP_DCC_Decoder_Core library (and the AP_DCC_library below it).
+// dcc.input() returns the command that was prepared by hostAccessory(), hostExtended() or hostPom().
+// The CVs are stored in EEPROM, with the CV number as index. EEPROM[0] tells if the EEPROM has been
+// initialised. CvProgramming::processMessage() writes the CV directly into EEPROM, as the library does.
+// LEDs, buttons and the decoder hardware do nothing; a button is never pushed.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+
+class Dcc {
+  public:
+    typedef enum {
+      IgnoreCmd,
+      MyAccessoryCmd,
+      AnyAccessoryCmd,
+      MyPomCmd,
+      AnyPomCmd,
+      SmCmd,
+      MyLocoSpeedCmd,
+      MyLocoF0F4Cmd,
+      MyLocoF5F8Cmd,
+      MyLocoF9F12Cmd
+    } CmdType_t;
+
+    CmdType_t cmdType;
+    bool input();
+
+    // Host only
+    bool pending;                               // A command has been prepared for the next input()
+};
+
+
+class Accessory {
+  public:
+    typedef enum {
+      basicAccessory,
+      extendedAccessory
+    } Command_t;
+
+    Command_t command;
+    uint16_t decoderAddress;                    // 1..511
+    uint16_t outputAddress;                     // 1..2048
+    uint8_t turnout;                            // 1..4
+    uint8_t position;                           // 0 = diverging (-), 1 = straight (+)
+    bool activate;
+    uint16_t signalHead;                        // Extended accessory: 1..2048
+    uint8_t signalAspect;                       // Extended accessory: 0..255
+};
+
+
+class CvAccess {
+  public:
+    typedef enum {
+      verifyByte,
+      writeByte,
+      bitManipulation
+    } Operation_t;
+
+    uint16_t number;
+    uint8_t value;
+    Operation_t operation;
+};
+
+
+class Loco {
+  public:
+    uint8_t speed;
+    bool forward;
+    uint8_t F0F4;
+    uint8_t F5F8;
+    uint8_t F9F12;
+};
+
+
+class CvValues {
+  public:
+    bool notInitialised();
+    void init(uint8_t decoderType, uint8_t softwareVersion);
+    uint8_t read(uint16_t number);
+    void write(uint16_t number, uint8_t value);
+    bool addressNotSet();
+    uint16_t storedAddress();
+};
+
+
+class CvProgramming {
+  public:
+    void processMessage(Dcc::CmdType_t cmdType);
+};
+
+
+class DecoderHardware {
+  public:
+    void init();
+    void update();
+};
+
+
+class BasicLed {
+  public:
+    void attach(uint8_t pin);
+    void turn_on();
+    void turn_off();
+    void activity();
+};
+
+
+class ToggleButton {
+  public:
+    void attach(uint8_t pin, uint8_t debounceTime);
+    void read();
+    bool changed();
+    bool isPressed();
+};
+
+
+// The CVs that are used by the decoder software
+const uint8_t ServoDecoder = 3;                 // Decoder type
+const uint8_t myAddrL = 1;
+const uint8_t myAddrH = 9;
+const uint8_t myRSAddr = 10;
+const uint8_t SkipUnEven = 11;
+
+extern Dcc dcc;
+extern Accessory accCmd;
+extern CvAccess cvCmd;
+extern Loco locoCmd;
+extern CvValues cvValues;
+extern CvProgramming cvProgramming;
+extern DecoderHardware decoderHardware;
+extern BasicLed onBoardLed;
@@ -0,0 +1,135 @@
+//*****************************************************************************************************
+//
+// File:      Arduino.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: lowByte() and highByte()
+//
+// Host (Linux) stand-in for the parts of the Arduino / DxCore core that the decoder software uses.
+//
+// Time does not run by itself: millis() and micros() return a simulated clock, which is advanced by
+// the test and benchmark drivers via hostAdvance() (see host.h). The registers that the software
+// touches (NVMCTRL, BOD and the PORT structures) are plain variables. The serial monitor (Serial1)
+// captures everything that is written, and returns bytes that were queued via hostSerialInput().
+//
+//******************************************************************************************************
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef bool boolean;
+
+#define HIGH                 1
+#define LOW                  0
+#define INPUT                0
+#define OUTPUT               1
+#define INPUT_PULLUP         2
+#define NOT_A_PIN            255
+#define PROGMEM
+#define lowByte(w)           ((uint8_t)((w) & 0xFF))
+#define highByte(w)          ((uint8_t)((w) >> 8))
+
+// The AVR64DA28 pins that are used in hardware.h
+#define PIN_PA0              0
+#define PIN_PA1              1
+#define PIN_PA2              2
+#define PIN_PA3              3
+#define PIN_PA4              4
+#define PIN_PA5              5
+#define PIN_PA6              6
+#define PIN_PA7              7
+#define PIN_PD0              12
+#define PIN_PD1              13
+#define PIN_PD2              14
+#define PIN_PD3              15
+#define PIN_PD4              16
+#define PIN_PD5              17
+#define PIN_PD6              18
+#define PIN_PD7              19
+#define PIN_PF0              20
+#define PIN_PF1              21
+
+// Memory sizes of the AVR64DA28
+#define EEPROM_SIZE          512
+#define PROGMEM_SIZE         0x10000UL
+#define PROGMEM_PAGE_SIZE    512
+
+#define bitRead(value, bit)  (((value) >> (bit)) & 0x01)
+
+#define DEC                  10
+#define HEX                  16
+#define BIN                  2
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+uint8_t digitalRead(uint8_t pin);
+uint8_t pgm_read_byte(const void* address);
+
+
+//******************************************************************************************************
+// Registers
+struct PORT_t {
+  volatile uint8_t DIR, DIRSET, DIRCLR, DIRTGL, OUT, OUTSET, OUTCLR, OUTTGL, IN, INTFLAGS;
+};
+extern PORT_t PORTA;
+extern PORT_t PORTD;
+extern PORT_t PORTF;
+PORT_t* digitalPinToPortStruct(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+
+struct NVMCTRL_t { volatile uint8_t CTRLA, STATUS; };
+extern NVMCTRL_t NVMCTRL;
+#define NVMCTRL_FBUSY_bm     0x01
+#define NVMCTRL_EEBUSY_bm    0x02
+
+struct BOD_t { volatile uint8_t CTRLA, CTRLB, VLMCTRLA, INTCTRL, INTFLAGS, STATUS; };
+extern BOD_t BOD;
+#define BOD_VLMLVL_25ABOVE_gc   0x03
+#define BOD_VLMCFG_BELOW_gc     0x00
+#define BOD_VLMIE_bm            0x01
+#define BOD_VLMIF_bm            0x01
+
+// An interrupt routine becomes a normal function, which the drivers may call to raise the interrupt
+#define ISR(vector)          extern "C" void vector(void)
+
+
+//******************************************************************************************************
+// Print and Stream
+class Print {
+  public:
+    virtual size_t write(uint8_t c) = 0;
+    virtual ~Print() {}
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(int value, int base = 10);
+    size_t print(unsigned int value, int base = 10);
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(double value, int digits = 2);
+    size_t println();
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+  private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+
+class HardwareSerial: public Print {
+  public:
+    void begin(unsigned long baud);
+    int available();
+    int read();
+    int availableForWrite();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size);
+    void flush();
+};
+
+extern HardwareSerial Serial1;
+
+#include "host.h"
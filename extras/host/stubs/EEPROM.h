@@ -0,0 +1,21 @@
+//*****************************************************************************************************
+//
+// File:      EEPROM.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host stand-in for the DxCore EEPROM library: EEPROM_SIZE bytes of RAM, which are erased (0xFF)
+// before the first access. Writes never leave the EEPROM busy.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+class EEPROMClass {
+  public:
+    uint8_t read(int index);
+    void write(int index, uint8_t value);
+    void update(int index, uint8_t value);
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,26 @@
+//*****************************************************************************************************
+//
+// File:      Flash.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host stand-in for the DxCore Flash library. The flash (PROGMEM_SIZE bytes) is erased (0xFF) before
+// the first access, and self-programming is always allowed.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#define FLASHWRITE_OK              0
+#define FLASHWRITE_FAIL            1
+
+class FlashClass {
+  public:
+    uint8_t checkWritable();
+    uint8_t erasePage(uint32_t address, uint8_t size = 1);
+    uint8_t writeWord(uint32_t address, uint16_t data);
+    uint8_t writeByte(uint32_t address, uint8_t data);
+    uint8_t readByte(uint32_t address);
+};
+
+extern FlashClass Flash;
@@ -0,0 +1,12 @@
+//*****************************************************************************************************
+//
+// File:      MyServo.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// configure.cpp and myRSBus.cpp include "MyServo.h". The Arduino IDE finds myServo.h on the case
+// insensitive file systems of Windows and macOS, but Linux does not.
+//
+//******************************************************************************************************
+#pragma once
+#include "../../../myServo.h"
@@ -0,0 +1,35 @@
+//*****************************************************************************************************
+//
+// File:      RSBus.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host stand-in for the RSbusConnection class of the RSbus library. Instead of transmitting, the
+// nibbles and bytes are counted, and the last value of each is kept for the tests.
+// The RS-Bus polling is simulated by setting feedbackRequested.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+typedef enum {
+  LowBits,
+  HighBits
+} Nibble_t;
+
+
+class RSbusConnection {
+  public:
+    uint8_t address;
+    bool feedbackRequested;
+
+    void send4bits(Nibble_t nibble, uint8_t value);
+    void send8bits(uint8_t value);
+    void checkConnection();
+
+    // Host only
+    unsigned long nibblesSent;                  // Number of send4bits() calls
+    unsigned long bytesSent;                    // Number of send8bits() calls
+    uint8_t lastNibble[2];                      // Last value sent for LowBits and HighBits
+    uint8_t lastByte;                           // Last value sent by send8bits()
+};
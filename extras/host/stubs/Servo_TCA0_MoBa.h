@@ -0,0 +1,59 @@
+//*****************************************************************************************************
+//
+// File:      Servo_TCA0_MoBa.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host stand-in for the ServoMoba class of the Servo-TCA library. There is no pulse signal; instead
+// a movement takes SIMULATED_CURVE_STEPS steps of (timeMultiplier * 20ms), after which checkServo()
+// sets movementCompleted. A curve that is traversed in normal direction ends at treshold 2, a curve
+// traversed in opposite direction at treshold 1. All pulse widths are recorded for the tests.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#define NUMBER_OF_LAST_CURVE       20
+#define MIN_PULSE_WIDTH            500
+#define MAX_PULSE_WIDTH            2500
+#define SIMULATED_CURVE_STEPS      12
+
+
+class ServoMoba {
+  public:
+    ServoMoba();
+    void attach(uint8_t pin);
+    void writeMicroseconds(uint16_t value);
+    void constantOutput(uint8_t level);
+    void initPulse(uint8_t idleLevel, uint8_t pulseOnBefore, uint8_t pulseOffAfter, uint16_t initWidth);
+    void initPower(bool idlePowerIsOff, uint8_t pin, uint8_t value, uint8_t powerOnBefore,
+      uint8_t powerOffAfter);
+    void powerOn();
+    void powerOff();
+
+    void setTreshold1(uint16_t value);
+    void setTreshold2(uint16_t value);
+    uint16_t getTreshold1();
+    uint16_t getTreshold2();
+
+    void initCurveFromEEPROM(uint8_t curve, uint8_t timeMultiplier, uint16_t startAdres);
+    void initCurveFromPROGMEM(uint8_t curve, uint8_t timeMultiplier);
+    uint16_t getFirstCurvePosition();
+    uint16_t getLastCurvePosition();
+    void moveServoAlongCurve(uint8_t direction);
+    void checkServo();
+
+    uint8_t previousCurve;                      // Curve (including direction) that was loaded last
+    volatile bool movementCompleted;            // False while the servo moves
+
+    // Host only
+    uint16_t pulseWidth;                        // Pulse width (in us) at the current position
+    unsigned long curvesDecoded;                // Number of initCurveFrom...() calls
+    unsigned long pulseConfigs;                 // Number of initPulse() calls
+
+  private:
+    uint16_t treshold1;
+    uint16_t treshold2;
+    uint8_t multiplier;                         // timeMultiplier of the loaded curve
+    unsigned long movementEnd;                  // millis() at which the current movement is completed
+};
@@ -0,0 +1,16 @@
+//*****************************************************************************************************
+//
+// File:      sleep.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host stand-in for <avr/sleep.h>. sleep_mode() returns immediately, as if an interrupt occurred.
+//
+//******************************************************************************************************
+#pragma once
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE      0
+
+void set_sleep_mode(uint8_t mode);
+void sleep_mode();
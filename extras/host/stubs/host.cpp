@@ -0,0 +1,360 @@
+//*****************************************************************************************************
+//
+// File:      host.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Implementation of the host stand-ins (see Arduino.h and the other headers in this directory).
+//
+//******************************************************************************************************
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Flash.h>
+#include <RSBus.h>
+#include <Servo_TCA0_MoBa.h>
+#include <AP_DCC_Decoder_Core.h>
+#include <avr/sleep.h>
+#include <deque>
+#include <stdio.h>
+
+
+//******************************************************************************************************
+// Time
+//******************************************************************************************************
+static unsigned long hostMicros = 0;
+
+void hostAdvance(unsigned long ms) { hostMicros += ms * 1000UL; }
+unsigned long millis() { return hostMicros / 1000UL; }
+unsigned long micros() { return hostMicros; }
+void delay(unsigned long ms) { hostAdvance(ms); }
+
+void set_sleep_mode(uint8_t) {}
+void sleep_mode() {}
+
+
+//******************************************************************************************************
+// Pins and registers
+//******************************************************************************************************
+PORT_t PORTA;
+PORT_t PORTD;
+PORT_t PORTF;
+NVMCTRL_t NVMCTRL;
+BOD_t BOD;
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+uint8_t digitalRead(uint8_t) { return HIGH; }
+uint8_t pgm_read_byte(const void* address) { return *(const uint8_t*)address; }
+
+PORT_t* digitalPinToPortStruct(uint8_t pin) {
+  if (pin < 8) return &PORTA;
+  if (pin < 20) return &PORTD;
+  return &PORTF;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin) {
+  if (pin < 8) return 1 << pin;
+  if (pin < 20) return 1 << (pin - 12);
+  return 1 << (pin - 20);
+}
+
+
+//******************************************************************************************************
+// Serial monitor
+//******************************************************************************************************
+HardwareSerial Serial1;
+std::string hostSerialOutput;
+static std::deque<uint8_t> serialInput;
+
+void hostSerialInput(const uint8_t* bytes, size_t size) {
+  for (size_t i = 0; i < size; i++) serialInput.push_back(bytes[i]);
+}
+
+void HardwareSerial::begin(unsigned long) {}
+int HardwareSerial::available() { return serialInput.size(); }
+int HardwareSerial::availableForWrite() { return 64; }
+void HardwareSerial::flush() {}
+
+int HardwareSerial::read() {
+  if (serialInput.empty()) return -1;
+  uint8_t value = serialInput.front();
+  serialInput.pop_front();
+  return value;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  hostSerialOutput.push_back((char)c);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) write(buffer[i]);
+  return size;
+}
+
+size_t Print::print(const char* s) {
+  size_t n = 0;
+  while (*s) n += write((uint8_t)*s++);
+  return n;
+}
+
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned int value, int base) { return printNumber(value, base); }
+size_t Print::print(unsigned long value, int base) { return printNumber(value, base); }
+size_t Print::println() { return print("\r\n"); }
+
+size_t Print::print(int value, int base) { return print((long)value, base); }
+
+size_t Print::print(long value, int base) {
+  if ((value < 0) && (base == 10)) return print('-') + printNumber(-value, base);
+  return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return print(buffer);
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+  char buffer[8 * sizeof(long) + 1];
+  char* s = &buffer[sizeof(buffer) - 1];
+  *s = '\0';
+  if (base < 2) base = 10;
+  do {
+    uint8_t digit = value % base;
+    *--s = (digit < 10) ? ('0' + digit) : ('A' + digit - 10);
+    value /= base;
+  } while (value);
+  return print(s);
+}
+
+
+//******************************************************************************************************
+// EEPROM and flash
+// The memories are function-local, such that they are erased before the constructors of global objects
+// (such as storedPositions) may access them.
+//******************************************************************************************************
+EEPROMClass EEPROM;
+FlashClass Flash;
+unsigned long hostEepromWrites = 0;
+uint16_t hostEepromLog[256];
+uint8_t hostEepromLogLength = 0;
+
+static uint8_t* eepromMemory() {
+  static uint8_t memory[EEPROM_SIZE];
+  static bool erased = false;
+  if (!erased) {
+    memset(memory, 0xFF, sizeof(memory));
+    erased = true;
+  }
+  return memory;
+}
+
+static uint8_t* flashMemory() {
+  static uint8_t memory[PROGMEM_SIZE];
+  static bool erased = false;
+  if (!erased) {
+    memset(memory, 0xFF, sizeof(memory));
+    erased = true;
+  }
+  return memory;
+}
+
+void hostEraseEEPROM() {
+  memset(eepromMemory(), 0xFF, EEPROM_SIZE);
+  hostEepromWrites = 0;
+  hostEepromLogLength = 0;
+}
+
+uint8_t EEPROMClass::read(int index) {
+  if ((index < 0) || (index >= EEPROM_SIZE)) return 0xFF;
+  return eepromMemory()[index];
+}
+
+void EEPROMClass::write(int index, uint8_t value) {
+  if ((index < 0) || (index >= EEPROM_SIZE)) return;
+  eepromMemory()[index] = value;
+  hostEepromWrites++;
+  hostEepromLog[hostEepromLogLength++] = index;
+}
+
+void EEPROMClass::update(int index, uint8_t value) {
+  if (read(index) != value) write(index, value);
+}
+
+uint8_t FlashClass::checkWritable() { return FLASHWRITE_OK; }
+
+uint8_t FlashClass::erasePage(uint32_t address, uint8_t size) {
+  uint32_t start = address - (address % PROGMEM_PAGE_SIZE);
+  if ((start + (uint32_t)size * PROGMEM_PAGE_SIZE) > PROGMEM_SIZE) return FLASHWRITE_FAIL;
+  memset(flashMemory() + start, 0xFF, (size_t)size * PROGMEM_PAGE_SIZE);
+  return FLASHWRITE_OK;
+}
+
+uint8_t FlashClass::writeWord(uint32_t address, uint16_t data) {
+  if ((address & 1) || ((address + 1) >= PROGMEM_SIZE)) return FLASHWRITE_FAIL;
+  flashMemory()[address] &= data & 0xFF;        // Flash bits can only be cleared
+  flashMemory()[address + 1] &= data >> 8;
+  return FLASHWRITE_OK;
+}
+
+uint8_t FlashClass::writeByte(uint32_t address, uint8_t data) {
+  if (address >= PROGMEM_SIZE) return FLASHWRITE_FAIL;
+  flashMemory()[address] &= data;
+  return FLASHWRITE_OK;
+}
+
+uint8_t FlashClass::readByte(uint32_t address) {
+  if (address >= PROGMEM_SIZE) return 0xFF;
+  return flashMemory()[address];
+}
+
+
+//******************************************************************************************************
+// RS-Bus
+//******************************************************************************************************
+void RSbusConnection::send4bits(Nibble_t nibble, uint8_t value) {
+  nibblesSent++;
+  lastNibble[nibble] = value;
+  feedbackRequested = false;
+}
+
+void RSbusConnection::send8bits(uint8_t value) {
+  bytesSent++;
+  lastByte = value;
+  feedbackRequested = false;
+}
+
+void RSbusConnection::checkConnection() {}
+
+
+//******************************************************************************************************
+// Servo
+//******************************************************************************************************
+ServoMoba::ServoMoba() {
+  movementCompleted = true;
+  treshold1 = 1000;
+  treshold2 = 2000;
+  multiplier = 1;
+}
+
+void ServoMoba::attach(uint8_t) {}
+void ServoMoba::writeMicroseconds(uint16_t value) { pulseWidth = value; }
+void ServoMoba::constantOutput(uint8_t) {}
+void ServoMoba::initPower(bool, uint8_t, uint8_t, uint8_t, uint8_t) {}
+void ServoMoba::powerOn() {}
+void ServoMoba::powerOff() {}
+void ServoMoba::setTreshold1(uint16_t value) { treshold1 = value; }
+void ServoMoba::setTreshold2(uint16_t value) { treshold2 = value; }
+uint16_t ServoMoba::getTreshold1() { return treshold1; }
+uint16_t ServoMoba::getTreshold2() { return treshold2; }
+uint16_t ServoMoba::getFirstCurvePosition() { return treshold1; }
+uint16_t ServoMoba::getLastCurvePosition() { return treshold2; }
+
+void ServoMoba::initPulse(uint8_t, uint8_t, uint8_t, uint16_t initWidth) {
+  pulseWidth = initWidth;
+  pulseConfigs++;
+}
+
+void ServoMoba::initCurveFromEEPROM(uint8_t curve, uint8_t timeMultiplier, uint16_t) {
+  initCurveFromPROGMEM(curve, timeMultiplier);
+}
+
+void ServoMoba::initCurveFromPROGMEM(uint8_t curve, uint8_t timeMultiplier) {
+  previousCurve = curve;
+  multiplier = (timeMultiplier == 0) ? 1 : timeMultiplier;
+  curvesDecoded++;
+}
+
+void ServoMoba::moveServoAlongCurve(uint8_t direction) {
+  movementCompleted = false;
+  movementEnd = millis() + (unsigned long)SIMULATED_CURVE_STEPS * multiplier * 20;
+  pulseWidth = direction ? treshold1 : treshold2;
+}
+
+void ServoMoba::checkServo() {
+  if (!movementCompleted && ((long)(millis() - movementEnd) >= 0)) movementCompleted = true;
+}
+
+
+//******************************************************************************************************
+// AP_DCC_Decoder_Core
+//******************************************************************************************************
+Dcc dcc;
+Accessory accCmd;
+CvAccess cvCmd;
+Loco locoCmd;
+CvValues cvValues;
+CvProgramming cvProgramming;
+DecoderHardware decoderHardware;
+BasicLed onBoardLed;
+
+#define INIT_MARKER          0x55               // EEPROM[0] if the CVs have been initialised
+
+bool Dcc::input() {
+  if (!pending) return false;
+  pending = false;
+  return true;
+}
+
+void hostAccessory(uint16_t address, uint8_t position, bool activate, bool ownAddress) {
+  accCmd.command = Accessory::basicAccessory;
+  accCmd.outputAddress = address;
+  accCmd.decoderAddress = ((address - 1) / 4) + 1;
+  accCmd.turnout = ((address - 1) % 4) + 1;
+  accCmd.position = position;
+  accCmd.activate = activate;
+  dcc.cmdType = ownAddress ? Dcc::MyAccessoryCmd : Dcc::AnyAccessoryCmd;
+  dcc.pending = true;
+}
+
+void hostExtended(uint16_t address, uint8_t aspect, bool ownAddress) {
+  accCmd.command = Accessory::extendedAccessory;
+  accCmd.signalHead = address;
+  accCmd.signalAspect = aspect;
+  dcc.cmdType = ownAddress ? Dcc::MyAccessoryCmd : Dcc::AnyAccessoryCmd;
+  dcc.pending = true;
+}
+
+void hostPom(uint16_t cvNumber, uint8_t value, bool write) {
+  cvCmd.number = cvNumber;
+  cvCmd.value = value;
+  cvCmd.operation = write ? CvAccess::writeByte : CvAccess::verifyByte;
+  dcc.cmdType = Dcc::MyPomCmd;
+  dcc.pending = true;
+}
+
+bool CvValues::notInitialised() { return (EEPROM.read(0) != INIT_MARKER); }
+
+void CvValues::init(uint8_t decoderType, uint8_t softwareVersion) {
+  if (!notInitialised()) return;
+  EEPROM.update(myAddrL, 1);
+  EEPROM.update(myAddrH, 0);
+  EEPROM.update(7, softwareVersion);
+  EEPROM.update(8, 13);                         // VID
+  EEPROM.update(27, decoderType);
+  EEPROM.update(myRSAddr, 1);
+  EEPROM.update(SkipUnEven, 0);
+  EEPROM.update(0, INIT_MARKER);
+}
+
+uint8_t CvValues::read(uint16_t number) { return EEPROM.read(number); }
+void CvValues::write(uint16_t number, uint8_t value) { EEPROM.update(number, value); }
+bool CvValues::addressNotSet() { return (storedAddress() == 0); }
+uint16_t CvValues::storedAddress() { return read(myAddrL) | ((read(myAddrH) & 0x07) << 8); }
+
+void CvProgramming::processMessage(Dcc::CmdType_t) {
+  if ((cvCmd.operation == CvAccess::writeByte) && (cvCmd.number > 0)) cvValues.write(cvCmd.number, cvCmd.value);
+}
+
+void DecoderHardware::init() {}
+void DecoderHardware::update() {}
+void BasicLed::attach(uint8_t) {}
+void BasicLed::turn_on() {}
+void BasicLed::turn_off() {}
+void BasicLed::activity() {}
+void ToggleButton::attach(uint8_t, uint8_t) {}
+void ToggleButton::read() {}
+bool ToggleButton::changed() { return false; }
+bool ToggleButton::isPressed() { return false; }
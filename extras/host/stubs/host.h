@@ -0,0 +1,36 @@
+//*****************************************************************************************************
+//
+// File:      host.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Functions for the test and benchmark drivers, to control the host stand-ins.
+//
+// - hostAdvance():       advances the simulated clock (millis() / micros())
+// - hostEraseEEPROM():   sets all EEPROM bytes to 0xFF, as on a new chip
+// - hostEepromWrites:    number of EEPROM bytes that have been written (wear)
+// - hostEepromLog:       EEPROM indexes in the order in which they were written (last 256)
+// - hostSerialInput():   bytes the decoder will receive via the serial monitor port
+// - hostSerialOutput:    bytes the decoder has sent via the serial monitor port
+// - hostAccessory():     the next dcc.input() returns this accessory command
+// - hostExtended():      the next dcc.input() returns this extended accessory (aspect) command
+// - hostPom():           the next dcc.input() returns this PoM command
+//
+//******************************************************************************************************
+#pragma once
+#include <stdint.h>
+#include <string>
+
+void hostAdvance(unsigned long ms);
+
+void hostEraseEEPROM();
+extern unsigned long hostEepromWrites;
+extern uint16_t hostEepromLog[256];
+extern uint8_t hostEepromLogLength;
+
+void hostSerialInput(const uint8_t* bytes, size_t size);
+extern std::string hostSerialOutput;
+
+void hostAccessory(uint16_t address, uint8_t position, bool activate, bool ownAddress);
+void hostExtended(uint16_t address, uint8_t aspect, bool ownAddress);
+void hostPom(uint16_t cvNumber, uint8_t value, bool write);
@@ -0,0 +1,556 @@
+//*****************************************************************************************************
+//
+// File:      tests.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Host tests for the decoder software (see readme.md, Host build).
+//
+// Each test runs in a child process of its own, and therefore starts with the state of a new decoder:
+// erased EEPROM, setup() not yet called and the time at 0. A test may call setup() and loop() as the
+// Arduino core does, or call the objects of the decoder software directly.
+//
+//******************************************************************************************************
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <AP_DCC_Decoder_Core.h>
+#include "hardware.h"
+#include "servo_CVs.h"
+#include "servo_position.h"
+#include "myServo.h"
+#include "myRSBus.h"
+#include "routes.h"
+#include "eeprom_writer.h"
+#include "power_budget.h"
+#include "config_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// The objects and functions of the main sketch
+void setup();
+void loop();
+extern MyServo servo[NUMBER_OF_SERVOS];
+extern MyRsBus rsbus;
+extern "C" void BOD_VLM_vect(void);
+
+#define CHECK(condition)                                                             \
+  do {                                                                               \
+    if (!(condition)) {                                                              \
+      fprintf(stderr, "    %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      exit(1);                                                                       \
+    }                                                                                \
+  } while (0)
+
+
+//******************************************************************************************************
+// Support functions
+//******************************************************************************************************
+static void run(unsigned long ms) {
+  // Calls loop() for ms milliseconds. Every call takes 1 ms.
+  for (unsigned long i = 0; i < ms; i++) {
+    hostAdvance(1);
+    loop();
+  }
+}
+
+static void boot() {
+  // setup(), followed by the start-up phase of the servos
+  setup();
+  run(1000);
+}
+
+static void command(uint16_t address, uint8_t position) {
+  hostAccessory(address, position, true, (address <= 4));
+  loop();
+}
+
+static uint8_t feedbackBits() {
+  // Bits 0 and 1 of the RS-Bus feedback: the position of servo 0 (0 = moving)
+  rsbus.feedbackRequested = true;
+  loop();
+  return rsbus.lastByte & 0x03;
+}
+
+static void saveRecord(uint8_t position0, uint8_t position1) {
+  storedPositions.saveServoPosition(0, position0);
+  storedPositions.saveServoPosition(1, position1);
+  storedPositions.flush();
+  eepromWriter.flush();
+}
+
+static uint8_t crc8(const uint8_t* bytes, uint8_t size) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < size; i++) {
+    crc ^= bytes[i];
+    for (uint8_t j = 0; j < 8; j++) crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+  }
+  return crc;
+}
+
+static void sendFrame(uint8_t cmd, uint16_t address, uint8_t len, const uint8_t* data) {
+  // A configuration protocol request. Data is only sent for write requests.
+  uint8_t frame[6 + CONFIG_MAX_DATA] = {CONFIG_SYNC, cmd, len, (uint8_t)(address & 0xFF), (uint8_t)(address >> 8)};
+  uint8_t size = 5;
+  if (data) for (uint8_t i = 0; i < len; i++) frame[size++] = data[i];
+  frame[size] = crc8(frame + 1, size - 1);
+  hostSerialInput(frame, size + 1);
+}
+
+static bool replyReceived(uint8_t cmd, uint16_t address, uint8_t len, const uint8_t* data) {
+  uint8_t frame[6 + CONFIG_MAX_DATA] = {CONFIG_SYNC, cmd, len, (uint8_t)(address & 0xFF), (uint8_t)(address >> 8)};
+  uint8_t size = 5;
+  if (data) for (uint8_t i = 0; i < len; i++) frame[size++] = data[i];
+  frame[size] = crc8(frame + 1, size - 1);
+  return (hostSerialOutput.find(std::string((const char*)frame, size + 1)) != std::string::npos);
+}
+
+static void writeRoute(uint8_t route, uint16_t address, uint8_t position, const uint8_t* steps, uint8_t size) {
+  uint16_t index = START_INDEX_ROUTES + (route * ROUTE_SIZE);
+  EEPROM.write(index, address & 0xFF);
+  EEPROM.write(index + 1, (address >> 8) | (position << 7));
+  for (uint8_t i = 0; i < size; i++) EEPROM.write(index + 2 + i, steps[i]);
+  EEPROM.write(index + 2 + size, ROUTE_END);
+  routes.init();
+}
+
+
+//******************************************************************************************************
+// EEPROM write queue (eeprom_writer.h)
+//******************************************************************************************************
+static void eepromWriterReadThrough() {
+  eepromWriter.write(400, 7);
+  CHECK(eepromWriter.read(400) == 7);
+  CHECK(EEPROM.read(400) == 0xFF);
+  CHECK(!eepromWriter.idle());
+  eepromWriter.update();
+  CHECK(EEPROM.read(400) == 7);
+  CHECK(eepromWriter.idle());
+}
+
+static void eepromWriterRewriteOrder() {
+  // A rewritten byte moves to the end of the queue
+  eepromWriter.write(400, 1);
+  eepromWriter.write(401, 2);
+  eepromWriter.write(400, 3);
+  eepromWriter.flush();
+  CHECK(hostEepromLogLength == 2);
+  CHECK(hostEepromLog[0] == 401);
+  CHECK(hostEepromLog[1] == 400);
+  CHECK(EEPROM.read(400) == 3);
+}
+
+static void eepromWriterSkipIdentical() {
+  EEPROM.write(400, 5);
+  eepromWriter.write(400, 5);
+  CHECK(eepromWriter.idle());
+  // Writing the EEPROM value again removes a queued value
+  eepromWriter.write(400, 6);
+  eepromWriter.write(400, 5);
+  CHECK(eepromWriter.idle());
+  CHECK(eepromWriter.read(400) == 5);
+}
+
+static void eepromWriterFullQueue() {
+  for (uint8_t i = 0; i <= EEPROM_QUEUE_SIZE; i++) eepromWriter.write(400 + i, i);
+  CHECK(EEPROM.read(400) == 0);                                 // Written to make room
+  CHECK(EEPROM.read(401) == 0xFF);
+  for (uint8_t i = 0; i <= EEPROM_QUEUE_SIZE; i++) CHECK(eepromWriter.read(400 + i) == i);
+  eepromWriter.flush();
+  for (uint8_t i = 0; i <= EEPROM_QUEUE_SIZE; i++) CHECK(EEPROM.read(400 + i) == i);
+}
+
+
+//******************************************************************************************************
+// Position journal (servo_position.h)
+//******************************************************************************************************
+static void journalDeferredWrite() {
+  storedPositions.saveServoPosition(0, 1);
+  hostAdvance(POSITION_WRITE_DELAY - 1);
+  storedPositions.check();
+  eepromWriter.flush();
+  CHECK(EEPROM.read(START_INDEX_POSITIONS) == 0xFF);
+  hostAdvance(1);
+  storedPositions.check();
+  eepromWriter.flush();
+  CHECK(EEPROM.read(START_INDEX_POSITIONS) == 0x01);            // Phase 0, servo 0 = 1
+}
+
+static void journalWrap() {
+  // After every record, a reboot should find the positions of that record as the newest ones
+  for (uint16_t n = 1; n <= (2 * NUMBER_OF_POSITION_RECORDS) + 3; n++) {
+    saveRecord(n & 1, (n >> 1) & 1);
+    ServoPosition rebooted;
+    CHECK(rebooted.servoPositions[0] == (n & 1));
+    CHECK(rebooted.servoPositions[1] == ((n >> 1) & 1));
+    if (n == NUMBER_OF_POSITION_RECORDS + 1) CHECK(EEPROM.read(START_INDEX_POSITIONS) & 0x80);
+  }
+  // Every record slot has been written three times, or two times
+  CHECK(hostEepromWrites <= (3 * NUMBER_OF_POSITION_RECORDS));
+}
+
+static void journalInterruptedWrite() {
+  // If power fails while the next record is written, the previous record is the newest one
+  saveRecord(1, 0);
+  saveRecord(0, 1);
+  EEPROM.write(START_INDEX_POSITIONS + POSITION_RECORD_SIZE, 0xFF); // Erased, as by an interrupted write
+  ServoPosition rebooted;
+  CHECK(rebooted.servoPositions[0] == 1);
+  CHECK(rebooted.servoPositions[1] == 0);
+}
+
+static void journalInterruptedWrap() {
+  // The same, if the interrupted write is the first record of a new pass (in the first slot)
+  for (uint16_t n = 1; n < NUMBER_OF_POSITION_RECORDS; n++) saveRecord(1, 0);
+  saveRecord(0, 1);                                             // Last slot of the first pass
+  EEPROM.write(START_INDEX_POSITIONS, 0xFF);                    // Erased, as by an interrupted write
+  storedPositions.reload();
+  CHECK(storedPositions.servoPositions[0] == 0);
+  CHECK(storedPositions.servoPositions[1] == 1);
+  // The next record is written into the first slot, with the phase of the new pass
+  saveRecord(1, 1);
+  CHECK(EEPROM.read(START_INDEX_POSITIONS) == (0x80 | 0x03));
+  ServoPosition rebooted;
+  CHECK(rebooted.servoPositions[0] == 1);
+  CHECK(rebooted.servoPositions[1] == 1);
+}
+
+static void journalPowerFail() {
+  storedPositions.saveServoPosition(1, 1);
+  BOD_VLM_vect();
+  storedPositions.check();
+  CHECK(EEPROM.read(START_INDEX_POSITIONS) == 0x02);
+}
+
+static void journalPowerFailWithoutPositions() {
+  // Queued CVs are written as well, even if there are no unsaved positions
+  eepromWriter.write(400, 9);
+  BOD_VLM_vect();
+  storedPositions.check();
+  CHECK(EEPROM.read(400) == 9);
+}
+
+static void journalClear() {
+  saveRecord(1, 1);
+  saveRecord(1, 0);
+  storedPositions.clearEEPROMCircularBufferValues();
+  for (uint16_t i = START_INDEX_POSITIONS; i < EEPROM_SIZE; i++) CHECK(EEPROM.read(i) == 0xFF);
+  CHECK(storedPositions.servoPositions[0] == 0);
+  saveRecord(0, 1);
+  CHECK(EEPROM.read(START_INDEX_POSITIONS) == 0x02);            // First slot, phase 0
+}
+
+
+//******************************************************************************************************
+// Routes (routes.h)
+//******************************************************************************************************
+static void routeSteps() {
+  boot();
+  const uint8_t steps[] = {0x80, 10, 0x81, 0};                  // Servo 0 to 1, 200ms, servo 1 to 1
+  writeRoute(0, 100, 1, steps, sizeof(steps));
+  command(100, 1);
+  CHECK(routes.running);
+  CHECK(servo[0].getRequestedPosition() == 1);
+  CHECK(servo[1].getRequestedPosition() == 0);
+  run(150);
+  CHECK(servo[1].getRequestedPosition() == 0);
+  run(60);
+  CHECK(servo[1].getRequestedPosition() == 1);
+  run(1);
+  CHECK(!routes.running);
+}
+
+static void routeRepeat() {
+  // A repeated command does not restart the route
+  boot();
+  const uint8_t steps[] = {0x80, 10, 0x81, 0};
+  writeRoute(0, 100, 1, steps, sizeof(steps));
+  command(100, 1);
+  run(150);
+  command(100, 1);
+  run(60);
+  CHECK(servo[1].getRequestedPosition() == 1);
+}
+
+static void routeValidation() {
+  boot();
+  const uint8_t badServo[] = {0x80, 0, NUMBER_OF_SERVOS, 0};
+  writeRoute(0, 100, 1, badServo, sizeof(badServo));
+  CHECK(!routes.start(100, 1));
+  const uint8_t steps[] = {0x80, 0};
+  writeRoute(0, 3000, 1, steps, sizeof(steps));
+  CHECK(!routes.start(3000, 1));
+  writeRoute(0, 100, 1, steps, sizeof(steps));
+  EEPROM.write(START_INDEX_ROUTES + 1, 0x80 | 0x10);            // Bit 4 of the high byte set
+  routes.init();
+  CHECK(!routes.start(100, 1));
+  CHECK(!routes.start(0, 0));                                   // Erased routes are not used
+}
+
+
+//******************************************************************************************************
+// Configuration protocol (config_protocol.h)
+//******************************************************************************************************
+static void configRead() {
+  boot();
+  hostSerialOutput.clear();
+  sendFrame(0x01, START_INDEX_SERVO_CVS, 4, nullptr);
+  run(1);
+  const uint8_t data[] = {1300 & 0xFF, 1300 >> 8, 1700 & 0xFF, 1700 >> 8};
+  CHECK(replyReceived(0x81, START_INDEX_SERVO_CVS, 4, data));
+}
+
+static void configWrite() {
+  boot();
+  hostSerialOutput.clear();
+  uint16_t index = START_INDEX_SERVO_CVS + Speed;
+  const uint8_t data[] = {3};
+  sendFrame(0x02, index, 1, data);
+  run(1);
+  CHECK(replyReceived(0x82, index, 0, nullptr));
+  CHECK(EEPROM.read(index) == 3);
+  CHECK(ReadServoCV(0, Speed) == 3);
+  CHECK(servo[0].timeMultiplier == 3);
+}
+
+static void configErrors() {
+  boot();
+  const uint8_t data[] = {3};
+  // Invalid CRC
+  hostSerialOutput.clear();
+  uint8_t frame[] = {CONFIG_SYNC, 0x02, 1, START_INDEX_SERVO_CVS, 0, 3, 0};
+  frame[6] = crc8(frame + 1, 5) ^ 0x01;
+  hostSerialInput(frame, sizeof(frame));
+  run(1);
+  CHECK(replyReceived(0xFF, START_INDEX_SERVO_CVS, 0, nullptr));
+  CHECK(ReadServoMin(0) == 1300);
+  // Writes below the servo specific part
+  hostSerialOutput.clear();
+  sendFrame(0x02, 10, 1, data);
+  run(1);
+  CHECK(replyReceived(0xFF, 10, 0, nullptr));
+  CHECK(EEPROM.read(10) != 3);
+}
+
+static void configTimeout() {
+  // An incomplete frame is discarded, and the next frame is received correctly
+  boot();
+  hostSerialOutput.clear();
+  const uint8_t partial[] = {CONFIG_SYNC, 0x01, 4};
+  hostSerialInput(partial, sizeof(partial));
+  run(CONFIG_FRAME_TIMEOUT + 10);
+  sendFrame(0x01, START_INDEX_SERVO_CVS, 2, nullptr);
+  run(1);
+  const uint8_t data[] = {1300 & 0xFF, 1300 >> 8};
+  CHECK(replyReceived(0x81, START_INDEX_SERVO_CVS, 2, data));
+}
+
+
+//******************************************************************************************************
+// Power budget (power_budget.h)
+//******************************************************************************************************
+static void powerBudgetQueue() {
+  // With MAX_MOVING_SERVOS slots, servos that wait get a slot in order of arrival
+  for (uint8_t i = 0; i < MAX_MOVING_SERVOS; i++) CHECK(powerBudget.request(i));
+  CHECK(!powerBudget.request(0));
+  CHECK(!powerBudget.request(1));
+  powerBudget.release();
+  CHECK(!powerBudget.request(1));                               // Servo 0 waits longer
+  CHECK(powerBudget.request(0));
+  powerBudget.release();
+  CHECK(powerBudget.request(1));
+  CHECK(!powerBudget.request(0));
+  powerBudget.cancel(0);
+  powerBudget.release();
+  CHECK(powerBudget.request(1));
+}
+
+
+//******************************************************************************************************
+// Initialisation (servo_CVs.h)
+//******************************************************************************************************
+static void firstBoot() {
+  setup();
+  CHECK(ReadServoMin(0) == 1300);
+  CHECK(ReadServoMax(1) == 1700);
+  CHECK(EEPROM.read(INDEX_EEPROM_LAYOUT) == EEPROM_LAYOUT);
+  CHECK(eepromWriter.idle());
+}
+
+static void layoutChanged() {
+  // After an upgrade the parts behind the curves are initialised, but calibrated servo CVs are kept
+  setup();
+  EEPROM.write(INDEX_EEPROM_LAYOUT, NUMBER_OF_SERVOS);          // Layout version 0
+  EEPROM.write(START_INDEX_ROUTES, 0x11);
+  EEPROM.write(START_INDEX_SERVO_CVS + MinLow, 1250 & 0xFF);
+  EEPROM.write(START_INDEX_SERVO_CVS + MinHigh, 1250 >> 8);
+  EEPROM.write(START_INDEX_SERVO_CURVES, 0x33);
+  setup();
+  CHECK(EEPROM.read(INDEX_EEPROM_LAYOUT) == EEPROM_LAYOUT);
+  CHECK(EEPROM.read(START_INDEX_ROUTES) == 0);
+  CHECK(ReadServoMin(0) == 1250);
+  CHECK(EEPROM.read(START_INDEX_SERVO_CURVES) == 0x33);
+}
+
+static void numberOfServosChanged() {
+  // With another number of servos, the servo CVs and curves have moved and are initialised as well
+  setup();
+  EEPROM.write(INDEX_EEPROM_LAYOUT, (EEPROM_LAYOUT_VERSION << 4) | (NUMBER_OF_SERVOS + 1));
+  EEPROM.write(START_INDEX_SERVO_CVS + MinLow, 1250 & 0xFF);
+  setup();
+  CHECK(EEPROM.read(INDEX_EEPROM_LAYOUT) == EEPROM_LAYOUT);
+  CHECK(ReadServoMin(0) == 1300);
+}
+
+
+//******************************************************************************************************
+// Servo commands (myServo.h)
+//******************************************************************************************************
+static void startUpPowerBudget() {
+  // Completing the start-up requires a slot from the power budget. With one free slot, the first
+  // servo that is due gets it, and the other servo is powered START_UP_POWER_TIME later.
+  setup();
+  CHECK(powerBudget.request(NUMBER_OF_SERVOS));                 // Leaves MAX_MOVING_SERVOS - 1 slots
+  unsigned long configs0 = servo[0].pulseConfigs;
+  unsigned long configs1 = servo[1].pulseConfigs;
+  run(1000);
+  CHECK((servo[0].pulseConfigs > configs0) != (servo[1].pulseConfigs > configs1));
+  run(START_UP_POWER_TIME);
+  CHECK(servo[0].pulseConfigs > configs0);
+  CHECK(servo[1].pulseConfigs > configs1);
+}
+
+
+static void motionFeedback() {
+  boot();
+  command(1, 1);
+  CHECK(feedbackBits() == 0);                                   // Moving
+  run(3000);
+  CHECK(feedbackBits() == 0x02);                                // Position 1
+}
+
+static void repeatedPom() {
+  // Repeated PoM commands and verify commands do not reconfigure the servo
+  boot();
+  hostPom(START_INDEX_SERVO_CVS + Speed, 3, true);
+  run(10);
+  CHECK(servo[0].timeMultiplier == 3);
+  unsigned long pulseConfigs = servo[0].pulseConfigs;
+  for (uint8_t i = 0; i < 3; i++) {
+    hostPom(START_INDEX_SERVO_CVS + Speed, 3, true);
+    run(10);
+    hostPom(START_INDEX_SERVO_CVS + Speed, 3, false);
+    run(10);
+  }
+  CHECK(servo[0].pulseConfigs == pulseConfigs);
+}
+
+static void pomAfterQueuedWrite() {
+  // A PoM write wins from an older value that is still queued for EEPROM
+  boot();
+  eepromWriter.write(START_INDEX_SERVO_CVS + Speed, 5);
+  hostPom(START_INDEX_SERVO_CVS + Speed, 3, true);
+  run(10);
+  eepromWriter.flush();
+  CHECK(EEPROM.read(START_INDEX_SERVO_CVS + Speed) == 3);
+  CHECK(servo[0].timeMultiplier == 3);
+}
+
+static void aspectRoundTrip() {
+  boot();
+  command(1, 1);
+  run(3000);
+  uint16_t position1 = servo[0].pulseWidth;
+  hostExtended(1, 2, true);
+  run(3000);
+  CHECK(servo[0].pulseWidth == 1300 + ((400 * 128) / 255));
+  CHECK(servo[0].idle());
+  command(1, 1);
+  run(3000);
+  CHECK(servo[0].pulseWidth == position1);
+  CHECK(servo[0].getTreshold1() == 1300);
+  CHECK(servo[0].getTreshold2() == 1700);
+  CHECK(servo[0].idle());
+}
+
+static void aspectOverridesSet() {
+  // An aspect command before the servo has arrived still ends with a position feedback
+  boot();
+  command(1, 1);
+  hostExtended(1, 2, true);
+  loop();
+  run(4000);
+  CHECK(feedbackBits() != 0);
+}
+
+static void aspectCvChange() {
+  // A servo that is parked at an intermediate position stays there, with the new Min and Max
+  boot();
+  hostExtended(1, 2, true);
+  run(3000);
+  hostPom(START_INDEX_SERVO_CVS + MinLow, 1100 & 0xFF, true);
+  run(10);
+  hostPom(START_INDEX_SERVO_CVS + MinHigh, 1100 >> 8, true);
+  run(10);
+  CHECK(servo[0].pulseWidth == 1100 + ((600 * 128) / 255));
+}
+
+
+//******************************************************************************************************
+struct Test {
+  const char* name;
+  void (*function)();
+};
+
+static const Test tests[] = {
+  {"eepromWriterReadThrough", eepromWriterReadThrough},
+  {"eepromWriterRewriteOrder", eepromWriterRewriteOrder},
+  {"eepromWriterSkipIdentical", eepromWriterSkipIdentical},
+  {"eepromWriterFullQueue", eepromWriterFullQueue},
+  {"journalDeferredWrite", journalDeferredWrite},
+  {"journalWrap", journalWrap},
+  {"journalInterruptedWrite", journalInterruptedWrite},
+  {"journalInterruptedWrap", journalInterruptedWrap},
+  {"journalPowerFail", journalPowerFail},
+  {"journalPowerFailWithoutPositions", journalPowerFailWithoutPositions},
+  {"journalClear", journalClear},
+  {"routeSteps", routeSteps},
+  {"routeRepeat", routeRepeat},
+  {"routeValidation", routeValidation},
+  {"configRead", configRead},
+  {"configWrite", configWrite},
+  {"configErrors", configErrors},
+  {"configTimeout", configTimeout},
+  {"powerBudgetQueue", powerBudgetQueue},
+  {"firstBoot", firstBoot},
+  {"layoutChanged", layoutChanged},
+  {"numberOfServosChanged", numberOfServosChanged},
+  {"startUpPowerBudget", startUpPowerBudget},
+  {"motionFeedback", motionFeedback},
+  {"repeatedPom", repeatedPom},
+  {"pomAfterQueuedWrite", pomAfterQueuedWrite},
+  {"aspectRoundTrip", aspectRoundTrip},
+  {"aspectOverridesSet", aspectOverridesSet},
+  {"aspectCvChange", aspectCvChange},
+};
+
+
+int main() {
+  int failed = 0;
+  for (const Test& test : tests) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+      test.function();
+      exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    bool passed = WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+    printf("%s %s\n", passed ? "PASS" : "FAIL", test.name);
+    if (!passed) failed++;
+  }
+  printf("%d of %d tests failed\n", failed, (int)(sizeof(tests) / sizeof(tests[0])));
+  return (failed == 0) ? 0 : 1;
+}
@@ -3,6 +3,23 @@
 // Author:    Aiko Pras
 // History:   2025/02/11 AP Version 1.0
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: a copy of the servo CVs is kept in RAM
+//            2026/10/16 agent: pin tables instead of per-servo switches
+//            2026/10/16 agent: MAX_MOVING_SERVOS
+//            2026/10/16 agent: EEPROM space for routes
+//            2026/10/16 agent: number of buttons derived from positionPins
+//            2026/10/16 agent: IDLE_SLEEP
+//            2026/10/16 agent: NUMBER_OF_POSITION_RECORDS for the journal
+//            2026/10/16 agent: POSITION_WRITE_DELAY and POWER_FAIL_FLUSH
+//            2026/10/16 agent: POSITION_RECORD_SIZE: one bit per servo
+//            2026/10/16 agent: FLASH_CURVE_PAGES and CURVE_LIBRARY_CV
+//            2026/10/16 agent: EEPROM space for servo addresses
+//            2026/10/16 agent: EEPROM space for intermediate positions
+//            2026/10/16 agent: MOTION_FEEDBACK
+//            2026/10/16 agent: EEPROM layout version in CV64
+//            2026/10/16 agent: check that the circular buffer fits in EEPROM
+//            2026/10/16 agent: a new layout version keeps the servo CVs and curves
+//            2026/10/16 agent: START_UP_POWER_TIME
 // 
 // Purpose:   AVR Servo - Details for Board V2.0 (2022/07)
 //  
@@ -25,6 +42,8 @@
 // - Clock: 24 Mhz                         - Might work at other speeds
 // - Millis: TCB2                          - Default
 // - BOD: 1,9V                             - Default
+// - BOD mode: Enabled                     - Needed for POWER_FAIL_FLUSH (see below)
+// - Flash write: Allow everywhere          - Needed to store curves in the curve library
 // - EEPROM: ***                           - Seems that retained doesn't work
 // - Startup time: 8ms                     - Default
 // - FLMAP: Use last section               - Here we store PROGMEM variables
@@ -39,10 +58,51 @@
 // Although the software is written to support multiple servos, the maximum amount is determined by:
 // - The board (V2.0 - 2022/07 supports 2 Servos, V3.0 - 2025/XX supports 3 servos)
 // - The number of TCA timers. Each TCA timer supporst upto 3 servos. The AVR64DA28 has a TCA timer.
-// - The EEPROM size. Size = 256 => 4 servos / size = 512 => 8 servos
-// - The RS-Bus code returns the positions of the first two servos only
+// - The EEPROM size. Size = 256 => 2 servos / size = 512 => 7 servos (see the EEPROM layout below)
+// - The RS-Bus code returns the positions of the first four servos only (the first two if skipUnEven)
 #define NUMBER_OF_SERVOS      2
 
+// Idle sleep (see the end of loop() in the main sketch)
+// If 1, the processor goes into idle sleep mode whenever there is nothing to do: no servo is moving or
+// waiting, no route is running and we are not in configuration mode. Every interrupt (DCC input, RS-Bus,
+// servo pulses and the 1 ms millis() timer) wakes the processor up again. If 0, the main loop keeps on
+// polling all inputs, as in earlier versions.
+#define IDLE_SLEEP            1
+
+// Maximum number of servos that may move simultaneously (see power_budget.h)
+// If more servos should move, for example because a route is set, the remaining servos have to wait
+// until one of the moving servos has completed its movement. This limits the inrush current, which
+// may be too much for weaker boosters. Should be between 1 and NUMBER_OF_SERVOS (= no limit).
+#define MAX_MOVING_SERVOS     NUMBER_OF_SERVOS
+
+// After reboot, powering a servo and moving it to its initial position draws as much current as a
+// normal movement. Therefore completing the start-up phase also needs a slot from the power budget.
+// That slot is kept for the time below (in ms), after which the next servo may complete its start-up.
+#define START_UP_POWER_TIME   500
+
+// Deferred storage of the servo positions (see servo_position.h)
+// A new servo position is kept in RAM, and written to EEPROM only after no new position has been 
+// requested for POSITION_WRITE_DELAY milliseconds. A turnout that is toggled several times in a row
+// therefore costs a single EEPROM write. If 0, every new position is written immediately.
+// If POWER_FAIL_FLUSH is 1, the Voltage Level Monitor (VLM) of the AVR-DA triggers an immediate write
+// of all unsaved positions once the supply voltage drops. Note that the VLM only works if BOD is
+// enabled (see the compile settings above).
+#define POSITION_WRITE_DELAY  2000
+#define POWER_FAIL_FLUSH      1
+
+// Curve library in flash (see curve_library.h)
+// The last FLASH_CURVE_PAGES pages (of 512 bytes) of flash hold a library of 10 curves per page.
+// The library is accessed via the command CVs CURVE_LIBRARY_CV .. CURVE_LIBRARY_CV + 3, which are
+// above the EEPROM space. The sketch itself should of course not grow into these pages.
+#define FLASH_CURVE_PAGES     4
+#define CURVE_LIBRARY_CV      1000
+
+// RS-Bus feedback after the movement (see myRSBus.h)
+// If MOTION_FEEDBACK is 1, a servo reports "moving" (both feedback bits 0) as soon as it receives a
+// command, and its new position once the movement has been completed. If 0, the new position is
+// reported immediately after the command has been received, as in previous versions.
+#define MOTION_FEEDBACK       1
+
 
 // In addition to the normal (DCC, RS-bus, LED, Taster) hardware, the AVR Servo decoder V2.0 has 
 // the follwing specific hardware:
@@ -57,19 +117,20 @@
 // - One extra input button
 // - One SCA and one SCL pin
 
-#define SERVO0_PIN            PIN_PF0
-#define SERVO1_PIN            PIN_PF1
-#define SERVO0_ENABLE_PIN     PIN_PA1
-#define SERVO1_ENABLE_PIN     PIN_PA2
+// The pulse, enable and relay pins are stored in tables, where the index is the servo number.
+// Each table must have NUMBER_OF_SERVOS entries. If a pin is not available on a board, its table
+// entry should be NOT_A_PIN. Since these tables are constexpr, they cost no RAM.
+constexpr uint8_t servoPins[]       = {PIN_PF0, PIN_PF1};
+constexpr uint8_t servoEnablePins[] = {PIN_PA1, PIN_PA2};
+constexpr uint8_t relaysPins[]      = {PIN_PA3, PIN_PD3};
 #define SERVO_ENABLE_VALUE    1         // servo gets powered with a high signal (board depended)
 
-#define POSITION0_PIN         PIN_PA5
-#define POSITION1_PIN         PIN_PA6
+// Buttons to directly change the position of a servo. Button i toggles servo i.
+// A board may have fewer buttons than servos (but not more).
+constexpr uint8_t positionPins[]    = {PIN_PA5, PIN_PA6};
+#define NUMBER_OF_BUTTONS     (sizeof(positionPins))
 #define DEBOUNCE_TIME         100       // 100 ms
 
-#define RELAYS0_PIN           PIN_PA3
-#define RELAYS1_PIN           PIN_PD3
-
 #define LED_CONFIG            PIN_PD4
 
 #define ROTARY_A              PIN_PD5
@@ -78,28 +139,48 @@
 
 #define Monitor               Serial1
 
+static_assert((MAX_MOVING_SERVOS >= 1) && (MAX_MOVING_SERVOS <= NUMBER_OF_SERVOS), "Invalid MAX_MOVING_SERVOS");
+static_assert(sizeof(servoPins) == NUMBER_OF_SERVOS, "servoPins needs an entry per servo");
+static_assert(sizeof(servoEnablePins) == NUMBER_OF_SERVOS, "servoEnablePins needs an entry per servo");
+static_assert(sizeof(relaysPins) == NUMBER_OF_SERVOS, "relaysPins needs an entry per servo");
+static_assert(sizeof(positionPins) <= NUMBER_OF_SERVOS, "positionPins has more buttons than servos");
+
 
 //*****************************************************************************************************
 // EEPROM specific settings and usage - Do not edit below!
 //*****************************************************************************************************
 //
-//   0        1 .. 63       64             65...                                                    511
-// +---+------------------+---+-----------------------------+----------------+-----------------------+
-// | I |    CVs: 1..63    | # |   Servo specific CVs: 65..  |     Curves     |    Circular Buffer    |
-// +---+------------------+---+-----------------------------+----------------+-----------------------+
+//   0        1 .. 63       64        65...                                                         511
+// +---+------------------+---+-------------------+----------+--------+-----+---------+--------------+
+// | I |    CVs: 1..63    | # |  Servo CVs: 65..  |  Curves  | Routes | Adr | Aspects | Circ. Buffer |
+// +---+------------------+---+-------------------+----------+--------+-----+---------+--------------+
 //
 // Contents of the EEPROM:
 // - The first EEPROM byte indicates if the EEPROM has been initialised (the value 0b01010101)
 // - The following 63 bytes hold the default CVs, as defined in "AP_DCC_Decoder_Core"
-// - Byte 64 holds the number of servos for this board (see #define above)
+// - Byte 64 (CV64) holds the number of servos for this board (see #define above) in bits 0..3, and the
+//   version of the EEPROM layout in bits 4..7. If the software finds another layout version, for 
+//   example after an upgrade that added routes, all values behind the curves (routes, servo addresses,
+//   intermediate positions and the circular buffer) are initialised again. Otherwise old values, such
+//   as records of the circular buffer, would be interpreted as routes. The servo CVs and curves are
+//   kept, since their place only depends on the number of servos. If the number of servos differs,
+//   all servo specific values (65 and higher) are initialised again. EEPROM_LAYOUT_VERSION must be 
+//   incremented for every change in the layout, and a change that moves the servo CVs or curves 
+//   should initialise these as well (see setup()).
 // - The following bytes hold the servo specific CVs. Per servo, 18 bytes are used. Thus for 2 servos
-//   this is 36 bytes, for 3 it is 54 and for 6 it is 108.
+//   this is 36 bytes, for 3 it is 54 and for 6 it is 108. A copy of these bytes is kept in RAM.
 // - After the servo specific CVs there is space for 2 or 4 curves. Each curve requires 48 bytes
 //   If the total EEPROM size is 256 bytes, we have room for 2 curves. If the EEPROM is 512, there
 //   is room for 4 curves.
+// - After the curves there is space for 2 or 4 routes. Each route requires 16 bytes, and holds the
+//   accessory address and position that start the route, followed by 7 steps. See routes.h for details.
+// - After the routes there are 2 bytes per servo for an (optional) accessory address of its own.
+//   See servo_addresses.h for details.
+// - After the servo addresses there are 4 bytes per servo for intermediate positions, which can be 
+//   selected via extended accessory (signal aspect) commands. See myServo.h for details.
 // - The last part of EEPROM space is used by the circular buffer. The goal of this buffer is
-//   to improve EEPROM endurance. The first byte holds the number of boots, the other bytes 
-//   store the most recently used servo curves / positions. See servo_position.h for details.
+//   to improve EEPROM endurance. It holds a journal of records, each with a phase bit and the
+//   positions of all servos at that moment, packed as one bit per servo. See servo_position.h.
 //
 // Example for a 512 byte EEPROM and 2 servos:
 // -       0: EEPROM has been initialized
@@ -111,8 +192,10 @@
 // - 149-196: Default curve 1
 // - 197-244: Default curve 2
 // - 245-292: Default curve 4
-// -     293: Number of Boots
-// - 294-511: circular buffer for holding the last curve/direction => 216 bytes
+// - 293-356: 4 routes => 16 bytes each
+// - 357-360: servo addresses => 2 bytes per servo
+// - 361-368: intermediate positions => 4 bytes per servo
+// - 369-511: circular buffer for holding the last positions => 143 bytes (143 records)
 //
 // All EEPROM indexes will be automatically generated, once the NUMBER_OF_SERVOS and the EEPROM_SIZE
 // are know. Therefore, do not change any of the #defines below. Note that it is important to embrace
@@ -123,20 +206,36 @@
   #error At least 256 bytes of EEPROM needed!
 #elif (EEPROM_SIZE < 512) 
   #define NUMBER_OF_CURVES 2
+  #define NUMBER_OF_ROUTES 2
 #else
   #define NUMBER_OF_CURVES 4
+  #define NUMBER_OF_ROUTES 4
 #endif
 
 #define NUMBER_OF_SERVO_CVS            18
+#define ROUTE_SIZE                     16
+#define NUMBER_OF_ASPECTS              4    // Intermediate positions per servo (see myServo.h)
+
+#define EEPROM_LAYOUT_VERSION          1    // 0 = the layout before routes were added
+#define INDEX_EEPROM_LAYOUT            64   // CV64
+#define EEPROM_LAYOUT                  ((EEPROM_LAYOUT_VERSION << 4) | NUMBER_OF_SERVOS)
 
 #define START_INDEX_SERVO_CVS          65
 #define START_INDEX_SERVO_CURVES       (START_INDEX_SERVO_CVS + (NUMBER_OF_SERVOS * NUMBER_OF_SERVO_CVS))
-#define EEPROM_BOOTS_INDEX             (START_INDEX_SERVO_CURVES + (NUMBER_OF_CURVES * 48))
+#define START_INDEX_ROUTES             (START_INDEX_SERVO_CURVES + (NUMBER_OF_CURVES * 48))
+#define START_INDEX_SERVO_ADDRESSES    (START_INDEX_ROUTES + (NUMBER_OF_ROUTES * ROUTE_SIZE))
+#define START_INDEX_ASPECTS            (START_INDEX_SERVO_ADDRESSES + (NUMBER_OF_SERVOS * 2))
+#define START_INDEX_POSITIONS          (START_INDEX_ASPECTS + (NUMBER_OF_SERVOS * NUMBER_OF_ASPECTS))
 
-#define TEMP_SIZE_CIRCULAR_BUFFER      (EEPROM_SIZE - EEPROM_BOOTS_INDEX - 1)
-
-#if (TEMP_SIZE_CIRCULAR_BUFFER > 250)  // The stored circular buffer indexes are 8 bit. Avoid Overflow 
-  #define SIZE_CIRCULAR_BUFFER         256
+#define SIZE_CIRCULAR_BUFFER           (EEPROM_SIZE - START_INDEX_POSITIONS)
+#if (NUMBER_OF_SERVOS <= 6)             // Byte 0 holds the phase bit and the positions of 6 servos
+  #define POSITION_RECORD_SIZE         1
+#elif (NUMBER_OF_SERVOS <= 14)          // Byte 1 holds the positions of the next 8 servos
+  #define POSITION_RECORD_SIZE         2
 #else
-  #define SIZE_CIRCULAR_BUFFER         TEMP_SIZE_CIRCULAR_BUFFER
+  #error Position records support at most 14 servos
 #endif
+#define NUMBER_OF_POSITION_RECORDS     (SIZE_CIRCULAR_BUFFER / POSITION_RECORD_SIZE)
+
+static_assert(SIZE_CIRCULAR_BUFFER >= (2 * POSITION_RECORD_SIZE), "EEPROM too small for this number of servos");
+static_assert(NUMBER_OF_POSITION_RECORDS <= 255, "Position record numbers should fit in a byte");
@@ -0,0 +1,51 @@
+// *****************************************************************************************************
+//
+// File:      logger.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Purpose:   Non-blocking output of (debug) messages on the serial monitor
+//
+// See logger.h for an explanation.
+//
+// *****************************************************************************************************
+#include "logger.h"
+#include "hardware.h"                       // For Monitor
+
+// Instantiate the logger object
+Logger logger;
+
+
+size_t Logger::write(uint8_t c) {
+  if (length >= LOG_BUFFER_SIZE) {          // Buffer full: drop the character
+    if (dropped < 0xFFFF) dropped++;
+    return 0;
+  }
+  buffer[head] = c;
+  head = (head + 1) % LOG_BUFFER_SIZE;
+  length++;
+  return 1;
+}
+
+
+void Logger::update() {
+  // Move characters into the transmit buffer of the serial port, as long as this doesn't block
+  while ((length > 0) && (Monitor.availableForWrite() > 0)) {
+    Monitor.write(buffer[tail]);
+    tail = (tail + 1) % LOG_BUFFER_SIZE;
+    length--;
+  }
+  // Once the buffer is empty, report if characters were dropped
+  if ((length == 0) && (dropped > 0)) {
+    uint16_t number = dropped;
+    dropped = 0;
+    print("[Log: ");
+    print(number);
+    println(" characters dropped]");
+  }
+}
+
+
+void Logger::flush() {
+  while (length > 0) update();
+}
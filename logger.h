@@ -0,0 +1,65 @@
+// *****************************************************************************************************
+//
+// File:      logger.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//
+// Purpose:   Non-blocking output of (debug) messages on the serial monitor
+//
+// Monitor.print() returns as soon as the characters fit into the (small) transmit buffer of the
+// serial port. If a message is longer, Monitor.print() waits until the UART has sent enough
+// characters; at 115200 baud this takes 87 us per character. A PoM message, for example, printed
+// about 30 characters, and the main loop could therefore be blocked for more than a millisecond,
+// during which DCC packets could be lost.
+//
+// The logger collects all characters in a RAM ring buffer of LOG_BUFFER_SIZE bytes. Adding a
+// character costs less than a microsecond. update(), which is called from the main loop, moves as
+// many characters from the ring buffer into the transmit buffer of the serial port as fit without
+// waiting; the transmit interrupt of the serial port subsequently sends them. If the ring buffer is
+// full, new characters are dropped (and counted), instead of blocking the decoder.
+//
+// Messages have a level. Only messages with a level up to LOG_LEVEL (below) are compiled; the other
+// messages cost neither code nor time. Use the macros below, which accept the same parameters as
+// Monitor.print() and Monitor.println():
+//   LOG_ERROR(...) / LOG_ERRORLN(...):  errors
+//   LOG_INFO(...)  / LOG_INFOLN(...):   normal messages, such as received PoM commands
+//   LOG_DEBUG(...) / LOG_DEBUGLN(...):  details that are only needed while testing
+//
+// Output of the timing measurements (timing.h) and of the binary configuration protocol 
+// (config_protocol.h) still goes directly to the serial monitor.
+//
+// *****************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_INFO      2
+#define LOG_LEVEL_DEBUG     3
+
+#define LOG_LEVEL           LOG_LEVEL_INFO    // Messages up to this level are compiled
+#define LOG_BUFFER_SIZE     256               // Size of the ring buffer (max 256)
+
+
+class Logger: public Print {
+  public:
+    size_t write(uint8_t c) override;           // Adds one character to the ring buffer
+    void update();                              // Should be called from main as frequent as possible
+    void flush();                               // Waits until all characters are sent (setup only)
+    uint16_t dropped;                           // Number of characters dropped (reported by update())
+
+  private:
+    uint8_t buffer[LOG_BUFFER_SIZE];
+    uint8_t head;                               // Position of the next character to be added
+    uint8_t tail;                               // Position of the next character to be sent
+    uint16_t length;                            // Number of characters in the buffer
+};
+
+extern Logger logger;
+
+#define LOG_ERROR(...)     do { if (LOG_LEVEL >= LOG_LEVEL_ERROR) logger.print(__VA_ARGS__); } while (0)
+#define LOG_ERRORLN(...)   do { if (LOG_LEVEL >= LOG_LEVEL_ERROR) logger.println(__VA_ARGS__); } while (0)
+#define LOG_INFO(...)      do { if (LOG_LEVEL >= LOG_LEVEL_INFO) logger.print(__VA_ARGS__); } while (0)
+#define LOG_INFOLN(...)    do { if (LOG_LEVEL >= LOG_LEVEL_INFO) logger.println(__VA_ARGS__); } while (0)
+#define LOG_DEBUG(...)     do { if (LOG_LEVEL >= LOG_LEVEL_DEBUG) logger.print(__VA_ARGS__); } while (0)
+#define LOG_DEBUGLN(...)   do { if (LOG_LEVEL >= LOG_LEVEL_DEBUG) logger.println(__VA_ARGS__); } while (0)
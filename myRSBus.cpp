@@ -4,12 +4,24 @@
 // Author:    Aiko Pras
 // History:   2025/05/05
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: sendFeedback() for table driven dispatch
+//            2026/10/16 agent: coalesced transmission of changed nibbles
+//            2026/10/16 agent: "moving" feedback
+//            2026/10/16 agent: feedback for all servos of the board
 // 
 // Purpose:   Implementation of RS-Bus feedback functions
 //
-// The first set of methods set the bits in the respective nibble, and send that nibble
-// via the RS-Bus connection. In addition, they update the 8-bit feedback data, which is
-// needed after the RS-Bus connection was temporary lost 
+// The first set of methods set the bits in the respective nibble (both bits are cleared if the
+// position is FEEDBACK_MOVING), and mark that nibble as changed
+// (dirty). In addition, they update the 8-bit feedback data, which is needed after the RS-Bus
+// connection was temporary lost.
+//
+// The changed nibbles are sent by checkRSFeedback(). A nibble that has not been sent during the last
+// RS_FEEDBACK_HOLDOFF milliseconds is sent immediately. If it changes again within that time, for 
+// example because a route moves both servos of a nibble, or because a turnout is toggled quickly,
+// only the latest value is sent once the holdoff time has passed. Since the holdoff time is about
+// one RS-Bus polling cycle, each nibble is sent at most once per cycle, and the PC receives the
+// final state without a queue of outdated states in front of it.
 //
 // The init() method must be called after the servos got attached, since it needs to know  
 // the positions of the servos after startup
@@ -26,18 +38,33 @@ extern MyServo servo[NUMBER_OF_SERVOS];
 
 
 // *****************************************************************************************************
+void MyRsBus::sendFeedback(uint8_t feedback, uint8_t position) {
+  // Sends the feedback for a servo, using the feedback slot that belongs to that servo.
+  switch (feedback) {
+    case FeedbackNibble0: sendNibble0(position); break;
+    case FeedbackNibble1: sendNibble1(position); break;
+    case FeedbackFB01: sendFB01(position); break;
+    case FeedbackFB23: sendFB23(position); break;
+    case FeedbackFB45: sendFB45(position); break;
+    case FeedbackFB67: sendFB67(position); break;
+  };
+}
+
+
 void MyRsBus::sendNibble0(uint8_t position) {
-  if (position) feedbackNibble0 = 0b00001010;
+  if (position == FEEDBACK_MOVING) feedbackNibble0 = 0b00000000;
+  else if (position) feedbackNibble0 = 0b00001010;
   else feedbackNibble0 = 0b00000101;
-  send4bits(LowBits, feedbackNibble0);
+  nibble0Dirty = true;
   feedback8Bit &= ~0b00001111;                  // clear nibble 0
   feedback8Bit |= feedbackNibble0;              // Add nibble 0
 }
 
 void MyRsBus::sendNibble1(uint8_t position) {
-  if (position) feedbackNibble1 = 0b00001010;
+  if (position == FEEDBACK_MOVING) feedbackNibble1 = 0b00000000;
+  else if (position) feedbackNibble1 = 0b00001010;
   else feedbackNibble1 = 0b00000101;
-  send4bits(HighBits, feedbackNibble1);
+  nibble1Dirty = true;
   feedback8Bit &= ~0b11110000;                  // clear nibble 1
   feedback8Bit |= (feedbackNibble1 * 16);       // Add nibble 1
 }
@@ -45,36 +72,40 @@ void MyRsBus::sendNibble1(uint8_t position) {
 
 void MyRsBus::sendFB01(uint8_t position) {
   feedbackNibble0 &= ~0b00000011;               // clear bits 0 and 1
-  if (position) feedbackNibble0 |= (0x01 << 1); // set bit 1
+  if (position == FEEDBACK_MOVING) {}           // both bits remain cleared
+  else if (position) feedbackNibble0 |= (0x01 << 1); // set bit 1
   else feedbackNibble0 |= (0x01 << 0);          // set bit 0
-  send4bits(LowBits, feedbackNibble0);             
+  nibble0Dirty = true;             
   feedback8Bit &= ~0b00001111;                  // clear nibble 0
   feedback8Bit |= feedbackNibble0;              // Add nibble 0
 }
 
 void MyRsBus::sendFB23(uint8_t position) {
   feedbackNibble0 &= ~0b00001100;               // clear bits 0 and 1
-  if (position) feedbackNibble0 |= (0x01 << 3); // set bit 3
+  if (position == FEEDBACK_MOVING) {}           // both bits remain cleared
+  else if (position) feedbackNibble0 |= (0x01 << 3); // set bit 3
   else feedbackNibble0 |= (0x01 << 2);          // set bit 2
-  send4bits(LowBits, feedbackNibble0);             
+  nibble0Dirty = true;             
   feedback8Bit &= ~0b00001111;                  // clear nibble 0
   feedback8Bit |= feedbackNibble0;              // Add nibble 0
 }
 
 void MyRsBus::sendFB45(uint8_t position) {                // xx10xxxx or xx01xxxx
   feedbackNibble1 &= ~0b00000011;               // clear bits 0 and 1
-  if (position) feedbackNibble1 |= (0x01 << 1); // set bit 1
+  if (position == FEEDBACK_MOVING) {}           // both bits remain cleared
+  else if (position) feedbackNibble1 |= (0x01 << 1); // set bit 1
   else feedbackNibble1 |= (0x01 << 0);          // set bit 0
-  send4bits(HighBits, feedbackNibble1);             
+  nibble1Dirty = true;             
   feedback8Bit &= ~0b11110000;                  // clear nibble 1
   feedback8Bit |= (feedbackNibble1 * 16);       // Add nibble 1
 }
 
 void MyRsBus::sendFB67(uint8_t position) {                // 10xxxxxx or 01xxxxxx
   feedbackNibble1 &= ~0b00001100;               // clear bits 0 and 1
-  if (position) feedbackNibble1 |= (0x01 << 3); // set bit 3
+  if (position == FEEDBACK_MOVING) {}           // both bits remain cleared
+  else if (position) feedbackNibble1 |= (0x01 << 3); // set bit 3
   else feedbackNibble1 |= (0x01 << 2);          // set bit 2
-  send4bits(HighBits, feedbackNibble1);             
+  nibble1Dirty = true;             
   feedback8Bit &= ~0b11110000;                  // clear nibble 1
   feedback8Bit |= (feedbackNibble1 * 16);       // Add nibble 1
 }
@@ -84,8 +115,25 @@ void MyRsBus::checkRSFeedback() {
   // Should be called from main as frequent as possible
   // As frequent as possible we should check if the RS-Bus asks for the most recent feedback data.
   // This is the case after a decoder restart or after a RS-Bus error. In addition, we have to 
-  // check if the buffer contains feedback data, and the ISR is ready to send that data via the UART.  
-  if (feedbackRequested) send8bits(feedback8Bit);
+  // check if the buffer contains feedback data, and the ISR is ready to send that data via the UART.
+  // Finally we check if changed nibbles should be sent (see above).
+  if (feedbackRequested) {
+    send8bits(feedback8Bit);                    // Includes all changed nibbles
+    nibble0Dirty = false;
+    nibble1Dirty = false;
+  }
+  else {
+    if (nibble0Dirty && ((millis() - nibble0Sent) >= RS_FEEDBACK_HOLDOFF)) {
+      send4bits(LowBits, feedbackNibble0);
+      nibble0Dirty = false;
+      nibble0Sent = millis();
+    }
+    if (nibble1Dirty && ((millis() - nibble1Sent) >= RS_FEEDBACK_HOLDOFF)) {
+      send4bits(HighBits, feedbackNibble1);
+      nibble1Dirty = false;
+      nibble1Sent = millis();
+    }
+  }
   checkConnection();
 }
 
@@ -102,34 +150,30 @@ void MyRsBus::init(uint8_t RSBusAddress, bool skipUnEven) {
 
 
 uint8_t MyRsBus::setNibble0(uint8_t skipUnEven) {
-  uint8_t result = 0;
-  if (skipUnEven) {
-    if (servo[0].previousCurve & DIRECTION) result = 0b00001010;
-    else result = 0b00000101;
-  }
-  else {
-    if (servo[0].previousCurve & DIRECTION) result |= (0x01 << 1);  // set bit 1;
-    else result |= (0x01 << 0);                                   // set bit 0;
-    if (servo[1].previousCurve & DIRECTION) result |= (0x01 << 3);  // set bit 1;
-    else result |= (0x01 << 2);                                   // set bit 0;
-  };
-  return result;
+  // If skipUnEven, the nibble holds servo 0 only. Otherwise it holds servo 0 (bits 0, 1) and 1 (bits 2, 3)
+  if (skipUnEven) return feedbackNibbleFor(0);
+  return feedbackBitsFor(0) | (feedbackBitsFor(1) << 2);
 }
 
 
 uint8_t MyRsBus::setNibble1(uint8_t skipUnEven) {
-  uint8_t result = 0;
-  if (skipUnEven) {
-    if (servo[1].previousCurve & DIRECTION) result = 0b00001010;
-    else result = 0b00000101;
-  }
-  else {
-    /*
-    if (servo3.previousCurve & DIRECTION) result |= (0x01 << 1);  // set bit 1;
-    else result (0x01 << 0);                                      // set bit 0;
-    if (servo4.previousCurve & DIRECTION) result |= (0x01 << 3);  // set bit 1;
-    else result (0x01 << 2);                                      // set bit 0;
-    */
-  };
-  return result;
+  // If skipUnEven, the nibble holds servo 1 only. Otherwise it holds servo 2 (bits 0, 1) and 3 (bits 2, 3)
+  if (skipUnEven) return feedbackNibbleFor(1);
+  return feedbackBitsFor(2) | (feedbackBitsFor(3) << 2);
+}
+
+
+uint8_t MyRsBus::feedbackNibbleFor(uint8_t servoNumber) {
+  // The complete nibble for one servo. 0 if this servo does not exist on this board
+  if (servoNumber >= NUMBER_OF_SERVOS) return 0;
+  if (servo[servoNumber].previousCurve & DIRECTION) return 0b00001010;
+  return 0b00000101;
+}
+
+
+uint8_t MyRsBus::feedbackBitsFor(uint8_t servoNumber) {
+  // The two feedback bits for one servo. 0 if this servo does not exist on this board
+  if (servoNumber >= NUMBER_OF_SERVOS) return 0;
+  if (servo[servoNumber].previousCurve & DIRECTION) return 0b10;
+  return 0b01;
 }
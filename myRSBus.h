@@ -4,14 +4,43 @@
 // Author:    Aiko Pras
 // History:   2025/05/05
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: sendFeedback() for table driven dispatch
+//            2026/10/16 agent: coalesced transmission of changed nibbles
+//            2026/10/16 agent: "moving" feedback
+//            2026/10/16 agent: feedback for all servos of the board
 // 
 // Purpose:   Declaration of RS-Bus feedback functions
 //
+// For each servo the feedback tells the position: 10 (or 1010 if the servo has a complete nibble) for
+// position 1, and 01 (or 0101) for position 0. If MOTION_FEEDBACK (hardware.h) is set, main sends
+// FEEDBACK_MOVING once a servo receives a command. This clears the feedback bits of that servo 
+// (00 or 0000), which is a combination that is never used for one of the end positions. Once the 
+// movement has been completed (MyServo::arrived()), main sends the new position. The PC software can
+// therefore release a route as soon as the turnout is really in its new position, without the need
+// for fixed safety timeouts.
+//
 //*****************************************************************************************************
 #pragma once
 #include <Arduino.h>                         // For general definitions
 #include <RSBus.h>                           // Inherits and extends the RSBus class
 
+#define RS_FEEDBACK_HOLDOFF   100            // Minimum time (ms) between two sends of the same nibble
+#define FEEDBACK_MOVING       0xFF           // position value for sendFeedback(): the servo is moving
+
+// Where (and how) the feedback for a servo is sent
+// - FeedbackNibble0/1: the servo has a complete nibble (used if skipUnEven)
+// - FeedbackFB01..FB67: the servo shares a nibble with another servo, and uses two bits
+typedef enum {
+  FeedbackNone,
+  FeedbackNibble0,
+  FeedbackNibble1,
+  FeedbackFB01,
+  FeedbackFB23,
+  FeedbackFB45,
+  FeedbackFB67
+} Feedback_t;
+
+
 class MyRsBus: public RSbusConnection {
   public:
     uint8_t feedbackNibble0;                 // The low nibble
@@ -21,6 +50,8 @@ class MyRsBus: public RSbusConnection {
     void init(uint8_t address, bool skip);
     void checkRSFeedback();                  // Should be called from main as frequent as possible
     
+    void sendFeedback(uint8_t feedback, uint8_t position); // feedback is a Feedback_t value
+
     void sendNibble0(uint8_t position);
     void sendNibble1(uint8_t position);
 
@@ -31,4 +62,13 @@ class MyRsBus: public RSbusConnection {
 
     uint8_t setNibble0(uint8_t skipUnEven);  // Determines the value for the first feedback nibble
     uint8_t setNibble1(uint8_t skipUnEven);  // Determines the value for the second feedback nibble
+
+  private:
+    bool nibble0Dirty;                       // feedbackNibble0 changed, but has not been sent yet
+    bool nibble1Dirty;                       // feedbackNibble1 changed, but has not been sent yet
+    unsigned long nibble0Sent;               // Time (in ms) feedbackNibble0 was sent last
+    unsigned long nibble1Sent;               // Time (in ms) feedbackNibble1 was sent last
+
+    uint8_t feedbackNibbleFor(uint8_t servoNumber); // Nibble value for a servo that has its own nibble
+    uint8_t feedbackBitsFor(uint8_t servoNumber);   // Two bit value for a servo that shares a nibble
 };
@@ -4,6 +4,23 @@
 // Author:    Aiko Pras
 // History:   2025/02/22 
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: optional timing of set() and checkServo()
+//            2026/10/16 agent: curves are only decoded if needed; asymmetric curves are preloaded
+//            2026/10/16 agent: pins are taken from the tables in hardware.h
+//            2026/10/16 agent: start-up phase is completed by checkServo()
+//            2026/10/16 agent: servos request a slot from the power budget before they move
+//            2026/10/16 agent: pending-command slot, the latest command wins
+//            2026/10/16 agent: idle()
+//            2026/10/16 agent: the stored position selects curve0 or curve1
+//            2026/10/16 agent: curveChanged()
+//            2026/10/16 agent: intermediate positions via setAspect()
+//            2026/10/16 agent: messages via the non-blocking logger
+//            2026/10/16 agent: reloadCVs()
+//            2026/10/16 agent: arrived()
+//            2026/10/16 agent: keep the temporary tresholds while parked at an intermediate position
+//            2026/10/16 agent: applyCVs() keeps a parked servo at its intermediate position
+//            2026/10/16 agent: arrival is also reported if setAspect() overrides set()
+//            2026/10/16 agent: completing the start-up phase requires a slot from the power budget
 // 
 // Extends the ServoMoba class with some extra functionality that we need for this decoder
 // A maximum of 6 servo objects can be instantiated
@@ -37,6 +54,9 @@
 #include "servo_CVs.h"               // Servo specific CVs
 #include "hardware.h"                // Pin and EEPROM definitions
 #include "servo_position.h"          // Storage for the servo positions in EEPROM
+#include "power_budget.h"            // Limits the number of simultaneously moving servos
+#include "logger.h"                  // Non-blocking messages on the serial monitor
+#include "timing.h"                  // Optional measurement of execution times
 
 
 void MyServo::init(uint8_t myNumber) {
@@ -55,17 +75,38 @@ void MyServo::init(uint8_t myNumber) {
   timeMultiplier = ReadServoCV(servoNumber, Speed);
   if (ReadServoCV(servoNumber, InvertServoDir)) invertServoDirection();
   //
-  // Read from the circular EEPROM buffer the previous curve for this servo, and load it.
-  previousCurve = storedPositions.servoPositions[servoNumber];
+  // Read from the circular EEPROM buffer the previous position for this servo, and load its curve.
+  // Once the servo is idle, checkServo() loads the curve for the opposite position.
+  if (storedPositions.servoPositions[servoNumber]) previousCurve = curve1;
+    else previousCurve = curve0;
   loadCurve(previousCurve);
+  preloadPending = true;
   //
   // Determine the initial pulse width 
   // If the curve has been traversed in opposite direction, we need to initialise using the first 
   // curve position. If it has been traversed in normal direction, we need to use the last position.
-  uint16_t initialPulseWidth; 
   if (previousCurve & DIRECTION) initialPulseWidth = getFirstCurvePosition();
     else initialPulseWidth = getLastCurvePosition();
   //
+  // Set the pin for the polarisation relay (if present) as output. 
+  // Check if polarisation should be inverted, and sets the relay to its initial value.
+  if (ReadServoCV(servoNumber, InvertRelais))  invertPolarisationRelay = true;
+    else invertPolarisationRelay = false;
+  initPolarisationRelay();
+  //
+  // Finally start the start-up phase, in which the pulse signal is kept at a constant level for a
+  // certain time. Instead of waiting here, we return immediately. checkServo() completes the
+  // initialisation once the start-up time has passed. In this way all servos go through their start-up
+  // phase simultaneously, and DCC and RS-Bus messages are handled during start-up.
+  startUpPulseSignal();
+  // 
+  // printInfoIni();  // For debugging
+}
+
+
+void MyServo::completeStartUp() {
+  // Called by checkServo() once the start-up time has passed, and a slot from the power budget has
+  // been granted.
   // First we configure all variables that relate to the pulse signal, and set that signal to an
   // initial value (high, low or continuous pulses). These variables are either stored in CV 10..14,
   // or predefined for the specific servo beeing used.
@@ -77,13 +118,11 @@ void MyServo::init(uint8_t myNumber) {
   //
   // Now we can attach the servo
   attachMyServo();
-  // Finally set the pin for the polarisation relay (if present) as output. 
-  // Check if polarisation should be inverted, and sets the relay to its initial value.
-  if (ReadServoCV(servoNumber, InvertRelais))  invertPolarisationRelay = true;
-    else invertPolarisationRelay = false;
-  initPolarisationRelay();
-  // 
-  // printInfoIni();  // For debugging
+  startingUp = false;
+  startUpTime = millis();                   // From now on: the time the servo got power
+  //
+  // If a new position was requested during start-up, we can now move the servo 
+  if (commandPending) executePendingCommand();
 }
 
 
@@ -93,57 +132,333 @@ void MyServo::set(uint8_t position) {
   //  0: diverging track / red / -   => we will use curve0
   //  1: straight track / green / +  => we will use curve1
   // Note: if the InvertServoDir CV is set, init has changed curve0 and curve1
-  // Check if the servo is already at the requested position
-  if ((position == 0) && (previousCurve == curve0)) return;
-  if ((position == 1) && (previousCurve == curve1)) return;
   //
-  // No, the servo is not at the requested position. But is it a symmetric curve?
-  // For that, we compare the CURVE bits (0...6) of either curve0 or curve1 to that of previousCurve
-  if ((previousCurve & CURVE) == (curve0 & CURVE))  // Symmetric curve?
-    previousCurve ^= DIRECTION;                     // Toggle the DIRECTION bit (MSB)
-  else {                                            // Curve is not symmetric
-    if (position == 0) loadCurve(curve0);           // curve0 is for position 0
-    else loadCurve(curve1);                         // curve1 is for position 1
-  };
+  // The requested position is stored in the pending-command slot. If the servo is idle, the command
+  // is executed immediately. If the servo is still starting up, moving or waiting for a power slot,
+  // checkServo() executes the command later. Since a newer command overwrites an older one, only the
+  // last requested position will be executed. If that is the position where the servo already is,
+  // the servo does not move at all (and no EEPROM write is needed).
+  requestedPosition = position;
+  requestedAspect = NO_ASPECT;
+  commandPending = true;
+  arrivalPending = true;
+  if (!startingUp && movementCompleted) executePendingCommand();
+}
+
+
+void MyServo::setAspect(uint8_t aspect) {
+  // Aspects 0 and 1 are the normal end positions. The next aspects select the intermediate positions.
+  // As with set(), the command is stored in the pending-command slot.
+  if (aspect < 2) {
+    set(aspect);
+    return;
+  }
+  if ((aspect - 2) >= NUMBER_OF_ASPECTS) return;
+  requestedAspect = aspect - 2;
+  commandPending = true;
+  if (!startingUp && movementCompleted) executePendingCommand();
+}
+
+
+uint8_t MyServo::getRequestedPosition() {
+  if (commandPending) return requestedPosition;
+  return getPosition();
+}
+
+
+bool MyServo::idle() {
+  return (!startingUp && movementCompleted && !commandPending && !preloadPending && !restorePending());
+}
+
+
+bool MyServo::restorePending() {
+  // Temporary tresholds are kept while the servo is parked at an intermediate position. They are
+  // restored once the servo is (moving) back at one of its end positions.
+  return (temporaryTresholds && (currentAspect == NO_ASPECT));
+}
+
+
+bool MyServo::arrived() {
+  if (arrivalPending && !startingUp && movementCompleted && !commandPending) {
+    arrivalPending = false;
+    return true;
+  }
+  return false;
+}
+
+
+void MyServo::checkServo() {
+  if (startingUp) {
+    if ((millis() - startUpTime) < startUpDuration) return;
+    // Powering the servo draws as much current as a movement, so we first need a slot from the
+    // power budget. If no slot is available, we try again during the next call.
+    if (!holdsPowerSlot) {
+      if (!powerBudget.request(servoNumber)) return;
+      holdsPowerSlot = true;
+    }
+    completeStartUp();
+    return;
+  }
+  ServoMoba::checkServo();
+  if (!movementCompleted) return;
+  // Give the power slot back once the movement is completed. After start-up the slot is kept
+  // until the servo has had START_UP_POWER_TIME to reach its initial position.
+  if (holdsPowerSlot && ((millis() - startUpTime) >= START_UP_POWER_TIME)) {
+    holdsPowerSlot = false;
+    powerBudget.release();
+  }
+  // After a move back from an intermediate position, the normal tresholds should be restored
+  if (restorePending()) restoreTresholds();
+  // Changed CVs are applied before the next command is executed
+  if (reloadPending) applyCVs();
+  // Is there a command waiting to be executed?
+  if (commandPending) {
+    executePendingCommand();
+    return;
+  }
+  // Use the time between movements to load the curve for the next movement
+  if (preloadPending) {
+    preloadPending = false;
+    preloadNextCurve();
+  }
+}
+
+
+void MyServo::executePendingCommand() {
+  // Should only be called if the servo is not moving. 
+  // Check if the servo is already at the requested position. If so, the command is done. 
+  bool done;
+  if (requestedAspect != NO_ASPECT) done = (requestedAspect == currentAspect);
+    else done = ((currentAspect == NO_ASPECT) && (requestedPosition == getPosition()));
+  if (done) {
+    commandPending = false;
+    powerBudget.cancel(servoNumber);                // In case we were waiting for a slot
+    return;
+  }
+  // No, the servo is not at the requested position. Before it may move, it needs a slot from the power
+  // budget. If no slot is available, the command remains pending and checkServo() tries again.
+  if (!holdsPowerSlot) {
+    if (!powerBudget.request(servoNumber)) return;
+    holdsPowerSlot = true;
+  }
+  commandPending = false;
+  if ((requestedAspect == NO_ASPECT) && (currentAspect == NO_ASPECT)) startMovement(requestedPosition);
+    else startAspectMovement();
+}
+
+
+void MyServo::startMovement(uint8_t position) {
+  TIMING_START(setStart);
+  // Load the curve for the requested position.
+  // For symmetric curves, and for asymmetric curves that were preloaded after the previous movement,
+  // the curve is already decoded and only the DIRECTION bit (MSB) of previousCurve changes.
+  uint8_t newCurve;
+  if (position == 0) newCurve = curve0;             // curve0 is for position 0
+  else newCurve = curve1;                           // curve1 is for position 1
+  loadCurve(newCurve);
+  previousCurve = newCurve;
   uint8_t dir = (previousCurve & DIRECTION) >> 7;   // Determine the new direction
   moveServoAlongCurve(dir);                         // Moves the servo!
-  storedPositions.saveServoPosition(servoNumber, previousCurve);
+  storedPositions.saveServoPosition(servoNumber, position);
   setPolarisationRelay(position);
+  preloadPending = true;
+  TIMING_STOP(ServoSet, setStart);
 }
 
+
+void MyServo::startAspectMovement() {
+  // Moves the servo from its current position to the requested position, where at least one of both
+  // is an intermediate position. The servo follows curve0 (without its direction bit), between
+  // temporary tresholds that are set to the pulse widths of both positions. If the servo should move
+  // to a lower pulse width, the curve is traversed in opposite direction.
+  // If the servo is parked at an intermediate position, the temporary tresholds of the previous move 
+  // are still set. The pulse widths of both positions are calculated with the normal tresholds.
+  uint16_t from;
+  uint16_t to;
+  if (temporaryTresholds) {
+    ServoMoba::setTreshold1(normalTreshold1);
+    ServoMoba::setTreshold2(normalTreshold2);
+    loadedCurve = NO_CURVE;
+  }
+  else {
+    normalTreshold1 = getTreshold1();
+    normalTreshold2 = getTreshold2();
+    curveAfterMove = previousCurve;                 // The end position the servo leaves
+  }
+  if (currentAspect == NO_ASPECT) from = endPulseWidth(previousCurve);
+    else from = aspectPulseWidth(currentAspect);
+  if (requestedAspect == NO_ASPECT) {
+    if (requestedPosition == 0) curveAfterMove = curve0;
+      else curveAfterMove = curve1;
+    to = endPulseWidth(curveAfterMove);
+  }
+  else to = aspectPulseWidth(requestedAspect);
+  //
+  uint8_t curve = curve0 & CURVE;
+  if (from <= to) {
+    ServoMoba::setTreshold1(from);
+    ServoMoba::setTreshold2(to);
+  }
+  else {
+    ServoMoba::setTreshold1(to);
+    ServoMoba::setTreshold2(from);
+    curve |= DIRECTION;
+  }
+  temporaryTresholds = true;
+  loadedCurve = NO_CURVE;
+  loadCurve(curve);
+  loadedCurve = NO_CURVE;                           // Decoded with the temporary tresholds
+  moveServoAlongCurve((curve & DIRECTION) >> 7);
+  currentAspect = requestedAspect;
+  preloadPending = false;
+  if (currentAspect == NO_ASPECT) {                 // Back at one of the end positions
+    storedPositions.saveServoPosition(servoNumber, requestedPosition);
+    setPolarisationRelay(requestedPosition);
+  }
+}
+
+
+void MyServo::restoreTresholds() {
+  ServoMoba::setTreshold1(normalTreshold1);
+  ServoMoba::setTreshold2(normalTreshold2);
+  temporaryTresholds = false;
+  loadCurve(curveAfterMove);                        // loadedCurve is NO_CURVE, thus the curve is decoded
+  preloadPending = true;
+}
+
+
+uint16_t MyServo::endPulseWidth(uint8_t curve) {
+  // As in init(): if the curve is traversed in opposite direction, the servo ends at the first curve
+  // position. Otherwise it ends at the last curve position. Loading the curve changes previousCurve.
+  uint8_t currentCurve = previousCurve;
+  loadCurve(curve);
+  previousCurve = currentCurve;
+  if (curve & DIRECTION) return getFirstCurvePosition();
+  return getLastCurvePosition();
+}
+
+
+uint16_t MyServo::aspectPulseWidth(uint8_t aspect) {
+  // The stored value (0..255) is the position between Min (treshold 1) and Max (treshold 2)
+  uint16_t min = getTreshold1();
+  uint16_t max = getTreshold2();
+  if (temporaryTresholds) {                         // Parked at an intermediate position
+    min = normalTreshold1;
+    max = normalTreshold2;
+  }
+  if (max < min) return min;
+  return min + (((uint32_t)(max - min) * ReadServoAspect(servoNumber, aspect)) / 255);
+}
+
+
 bool MyServo::getPosition() {
-  if (previousCurve == curve0) return 0;
+  // During and after a move with temporary tresholds, previousCurve is the curve used for that move.
+  // The switch position is then given by the curve of the end position the servo left (or moves to).
+  uint8_t curve = previousCurve;
+  if (temporaryTresholds) curve = curveAfterMove;
+  if (curve == curve0) return 0;
   else return 1;
 }
 
+//******************************************************************************************************
+void MyServo::reloadCVs() {
+  reloadPending = true;
+  if (!startingUp && movementCompleted && !restorePending()) applyCVs();
+}
+
+
+void MyServo::applyCVs() {
+  // Same steps as init(), but the servo keeps its current position. If the servo is (still) at the
+  // end of the same curve, previousCurve does not change. If InvertServoDir changed, curve0 and 
+  // curve1 are swapped, and the same physical position now belongs to the other switch position.
+  // If the servo is parked at an intermediate position, it keeps its temporary tresholds and stays 
+  // at that intermediate position (with the new Min and Max). Only the normal tresholds, and the end
+  // position to return to, are updated.
+  reloadPending = false;
+  bool parked = (currentAspect != NO_ASPECT);
+  uint8_t oldCurve = previousCurve;
+  if (parked) oldCurve = curveAfterMove;
+  bool position = getPosition();
+  if (parked) {
+    normalTreshold1 = ReadServoMin(servoNumber);
+    normalTreshold2 = ReadServoMax(servoNumber);
+  }
+  else {
+    setTreshold1(ReadServoMin(servoNumber));        // Also invalidates the loaded curve
+    setTreshold2(ReadServoMax(servoNumber));
+  }
+  servoDirectionInverted = false;
+  copyCurveCVs();
+  timeMultiplier = ReadServoCV(servoNumber, Speed);
+  if (ReadServoCV(servoNumber, InvertServoDir)) invertServoDirection();
+  uint8_t newCurve;
+  if (oldCurve == curve0) newCurve = curve0;
+    else if (oldCurve == curve1) newCurve = curve1;
+    else if (position) newCurve = curve1;
+    else newCurve = curve0;
+  //
+  // The pulse and power signals. The pulse width is the end of the curve with the new tresholds, or
+  // the intermediate position the servo is parked at.
+  uint16_t pulseWidth;
+  if (parked) {
+    curveAfterMove = newCurve;
+    pulseWidth = aspectPulseWidth(currentAspect);
+  }
+  else {
+    previousCurve = newCurve;
+    loadCurve(previousCurve);
+    preloadPending = true;
+    if (previousCurve & DIRECTION) pulseWidth = getFirstCurvePosition();
+      else pulseWidth = getLastCurvePosition();
+  }
+  configPulseSignal(pulseWidth);
+  configPowerSignal();
+  //
+  invertPolarisationRelay = (ReadServoCV(servoNumber, InvertRelais) != 0);
+  setPolarisationRelay(getPosition());
+}
+
+
 //******************************************************************************************************
 // Private support functions during initialisation
 //******************************************************************************************************
+void MyServo::startUpPulseSignal() {
+  // Routine that determines, depending on the servo type, the level and duration of the pulse signal
+  // directly after reboot. 
+  switch (ReadServoCV(servoNumber, ServoType)) {
+    case 1:  // Uhlenbrock Standard-Servo: Art. 81420 / Weinert Mein Antrieb
+    case 2:  // MBTronic
+    case 3:  // SG90 - Tower Pro
+    case 4:  // SG90 - TZT
+      pulseAfterReboot(HIGH, 10);
+    break;
+    default: // Use the values from the pulse CVs
+      pulseAfterReboot(
+        ReadServoCV(servoNumber, PulseStartUpValue),
+        ReadServoCV(servoNumber, PulseStartUpDelay)
+        );
+    break;
+  };
+};
+
+
 void MyServo::configPulseSignal(uint16_t initialPulseWidth) {
   // Routine that reads the pulse related CVs and calls the servoTCA's library initPulse. 
   // The parameters for initPulse depend on the servo type, 
   switch (ReadServoCV(servoNumber, ServoType)) {
     case 1:  // Uhlenbrock Standard-Servo: Art. 81420 / Weinert Mein Antrieb
-      pulseAfterReboot(HIGH, 10);
       initPulse(1, 0, 4, initialPulseWidth);
     break;
     case 2:  // MBTronic
-      pulseAfterReboot(HIGH, 10);
       initPulse(1, 0, 10, initialPulseWidth);
     break;
     case 3:  // SG90 - Tower Pro
-      pulseAfterReboot(HIGH, 10);
       initPulse(1, 0, 10, initialPulseWidth);
     break;
     case 4:  // SG90 - TZT
-      pulseAfterReboot(HIGH, 10);
       initPulse(1, 0, 3, initialPulseWidth);
     break;
     default: // Use the values from the pulse CVs
-      pulseAfterReboot(
-        ReadServoCV(servoNumber, PulseStartUpValue),
-        ReadServoCV(servoNumber, PulseStartUpDelay)
-        );
       if (ReadServoCV(servoNumber, IdlePulseDefault) > 1)    // continuous pulse
         writeMicroseconds(initialPulseWidth);
       else {
@@ -194,114 +509,33 @@ void MyServo::configPowerSignal() {
   };
   // STEP 2: Call initPower(), but only if the enable pin for has been defined in "hardware.h".
   // SERVO_ENABLE_VALUE is a board specific constant, and thus defined in "hardware.h" (and not a CV)
-  switch (servoNumber) {
-    case 0: 
-      #ifdef SERVO0_ENABLE_PIN
-        initPower(idlePowerIsOff, SERVO0_ENABLE_PIN, SERVO_ENABLE_VALUE, powerOnBefore, powerOffAfter);
-      #endif
-    break;
-    case 1: 
-      #ifdef SERVO1_ENABLE_PIN
-        initPower(idlePowerIsOff, SERVO1_ENABLE_PIN, SERVO_ENABLE_VALUE, powerOnBefore, powerOffAfter);
-      #endif
-    break;
-    case 2: 
-      #ifdef SERVO2_ENABLE_PIN
-        initPower(idlePowerIsOff, SERVO2_ENABLE_PIN, SERVO_ENABLE_VALUE, powerOnBefore, powerOffAfter);
-      #endif
-    break;
-    case 3: 
-      #ifdef SERVO3_ENABLE_PIN
-        initPower(idlePowerIsOff, SERVO3_ENABLE_PIN, SERVO_ENABLE_VALUE, powerOnBefore, powerOffAfter);
-      #endif
-    break;
-    case 4: 
-      #ifdef SERVO4_ENABLE_PIN
-        initPower(idlePowerIsOff, SERVO4_ENABLE_PIN, SERVO_ENABLE_VALUE, powerOnBefore, powerOffAfter);
-      #endif
-    break;
-    case 5: 
-      #ifdef SERVO5_ENABLE_PIN
-        initPower(idlePowerIsOff, SERVO5_ENABLE_PIN, SERVO_ENABLE_VALUE, powerOnBefore, powerOffAfter);
-      #endif
-    break;
-  };
+  uint8_t enablePin = servoEnablePins[servoNumber];
+  if (enablePin != NOT_A_PIN) 
+    initPower(idlePowerIsOff, enablePin, SERVO_ENABLE_VALUE, powerOnBefore, powerOffAfter);
 };
 
 
 void MyServo::attachMyServo() { 
   // hardware.h is checked if the pin to which this servo should be attached, has been defined.
   // In this way we ensure that this (part of the) code runs for different numbers of servos.
-  switch (servoNumber) {
-    case 0: 
-      #ifdef SERVO0_PIN
-        attach(SERVO0_PIN); 
-      #endif
-    break;
-    case 1: 
-      #ifdef SERVO1_PIN
-        attach(SERVO1_PIN); 
-      #endif
-    break;
-    case 2: 
-      #ifdef SERVO2_PIN
-        attach(SERVO2_PIN); 
-      #endif
-    break;
-    case 3: 
-      #ifdef SERVO3_PIN
-        attach(SERVO3_PIN); 
-      #endif
-    break;
-    case 4: 
-      #ifdef SERVO4_PIN
-        attach(SERVO4_PIN); 
-      #endif
-    break;
-    case 5: 
-      #ifdef SERVO5_PIN
-        attach(SERVO5_PIN); 
-      #endif
-    break;
-  };
+  if (servoPins[servoNumber] != NOT_A_PIN) attach(servoPins[servoNumber]);
 };
 
 
 void MyServo::initPolarisationRelay() { 
   // hardware.h is checked if the pin to which this relay should be attached, has been defined.
   // In this way we ensure that this (part of the) code runs for different numbers of servos.
-  switch (servoNumber) {
-    case 0: 
-      #ifdef RELAYS0_PIN
-         pinMode(RELAYS0_PIN, OUTPUT);
-      #endif
-    break;
-    case 1: 
-       #ifdef RELAYS1_PIN
-         pinMode(RELAYS1_PIN, OUTPUT);
-      #endif
-    break;
-    case 2: 
-       #ifdef RELAYS2_PIN
-         pinMode(RELAYS2_PIN, OUTPUT);
-      #endif
-    break;
-    case 3: 
-       #ifdef RELAYS3_PIN
-         pinMode(RELAYS3_PIN, OUTPUT);
-      #endif
-    break;
-    case 4: 
-       #ifdef RELAYS4_PIN
-         pinMode(RELAYS4_PIN, OUTPUT);
-      #endif
-    break;
-    case 5: 
-       #ifdef RELAYS5_PIN
-         pinMode(RELAYS5_PIN, OUTPUT);
-      #endif
-    break;
-  };
+  // To switch the relay without a lookup of port and pin for every switch command, we store a
+  // pointer to the PORT registers and the bit mask of the pin. If there is no relay, the bit mask
+  // remains 0, so writing to the port has no effect.
+  uint8_t relayPin = relaysPins[servoNumber];
+  relayPort = &PORTA;
+  relayMask = 0;
+  if (relayPin != NOT_A_PIN) {
+    pinMode(relayPin, OUTPUT);
+    relayPort = digitalPinToPortStruct(relayPin);
+    relayMask = digitalPinToBitMask(relayPin);
+  }
   // Now we have to set the polarisation relay to its initial position
   // This is done by checking the DIRECTION bit in previousCurve 
   bool initialPosition = previousCurve & DIRECTION;
@@ -336,20 +570,58 @@ void MyServo::invertServoDirection() {
 
 void MyServo::loadCurve(uint8_t curve) {
   // May be called to set new speed 
+  // If the same curve has already been decoded with the same timeMultiplier, only the direction
+  // (MSB) may differ. In that case there is no need to decode the curve again.
+  if (((curve & CURVE) == loadedCurve) && (timeMultiplier == loadedMultiplier)) {
+    previousCurve = curve;
+    return;
+  }
   uint8_t curveNumber = curve & INDEX;            // EEPROM: 0, 1, 2 or 3 / PROGMEM: 
   if (curve & EPROM) {                            // EEPROM bit is set??
     if (curveNumber < NUMBER_OF_CURVES) {         // Protection, in case an erroneous CV value was entered
       uint16_t startAdres = START_INDEX_SERVO_CURVES + (curveNumber * 48);
       initCurveFromEEPROM(curve, timeMultiplier, startAdres);
+      loadedCurve = curve & CURVE;
+      loadedMultiplier = timeMultiplier;
     }
   }
   else
     if (curveNumber <= NUMBER_OF_LAST_CURVE) {    // Protection, in case an erroneous CV value was entered
     initCurveFromPROGMEM(curve, timeMultiplier);
+    loadedCurve = curve & CURVE;
+    loadedMultiplier = timeMultiplier;
   }
 };
 
 
+void MyServo::preloadNextCurve() {
+  // Only needed for asymmetric curves; symmetric curves use the same decoded curve for both positions. 
+  // Loading a curve changes previousCurve, which should however keep the current position.
+  if ((curve0 & CURVE) == (curve1 & CURVE)) return;
+  uint8_t currentCurve = previousCurve;
+  if (currentCurve == curve0) loadCurve(curve1);
+    else loadCurve(curve0);
+  previousCurve = currentCurve;
+};
+
+
+void MyServo::setTreshold1(uint16_t value) {
+  ServoMoba::setTreshold1(value);
+  loadedCurve = NO_CURVE;                         // The decoded curve depends on the tresholds
+};
+
+
+void MyServo::setTreshold2(uint16_t value) {
+  ServoMoba::setTreshold2(value);
+  loadedCurve = NO_CURVE;
+};
+
+
+void MyServo::curveChanged(uint8_t slot) {
+  if (loadedCurve == (EPROM | slot)) loadedCurve = NO_CURVE;
+};
+
+
 
 //******************************************************************************************************
 // Private support functions during operation
@@ -361,63 +633,35 @@ void MyServo::setPolarisationRelay(bool frogPosition) {
   // Thus, if the values of frogPosition and invertPolarisationRelay match, the relay should
   // be activated.
   boolean activateRelay = (invertPolarisationRelay == frogPosition);
-  // hardware.h is checked if the pin to which this relay should be attached, has been defined.
-  // In this way we ensure that this (part of the) code runs for different numbers of servos.
-  // To avoid the overhead of the standard Arduino digitalWrite() routine, we use digitalWriteFast()
-  // See: https://github.com/SpenceKonde/DxCore/blob/master/megaavr/extras/Ref_Digital.md
-  switch (servoNumber) {
-    case 0: 
-      #ifdef RELAYS0_PIN
-        digitalWriteFast(RELAYS0_PIN, activateRelay);
-      #endif
-    break;
-    case 1: 
-       #ifdef RELAYS1_PIN
-        digitalWriteFast(RELAYS1_PIN, activateRelay);
-      #endif
-    break;
-    case 2: 
-       #ifdef RELAYS2_PIN
-        digitalWriteFast(RELAYS2_PIN, activateRelay);
-      #endif
-    break;
-    case 3: 
-       #ifdef RELAYS3_PIN
-        digitalWriteFast(RELAYS3_PIN, activateRelay);
-      #endif
-    break;
-    case 4: 
-       #ifdef RELAYS4_PIN
-        digitalWriteFast(RELAYS4_PIN, activateRelay);
-      #endif
-    break;
-    case 5: 
-       #ifdef RELAYS5_PIN
-        digitalWriteFast(RELAYS5_PIN, activateRelay);
-      #endif
-    break;
-  };
+  // To avoid the overhead of the standard Arduino digitalWrite() routine, we write the bit mask 
+  // that was determined by initPolarisationRelay() directly into the OUTSET or OUTCLR register.
+  // Both are single, atomic stores, without any lookups or read-modify-write.
+  if (activateRelay) relayPort->OUTSET = relayMask;
+    else relayPort->OUTCLR = relayMask;
 };
 
 
 void MyServo::pulseAfterReboot(uint8_t level, uint8_t waitTime) {
   // Set the pulse signal to a high or low level, and keep that level for a certain time
-  constantOutput(level);   // 0 = LOW (0V), 1 = HIGH (3,3 or 5V)
-  delay(waitTime * 20);    // waitTime is in 20ms ticks
+  // The time is not waited for here, but checked by checkServo()
+  constantOutput(level);                    // 0 = LOW (0V), 1 = HIGH (3,3 or 5V)
+  startUpDuration = waitTime * 20;          // waitTime is in 20ms ticks
+  startUpTime = millis();
+  startingUp = true;
 }
 
 
 void MyServo::printInfoIni() {
-  Monitor.print("Servo: "); Monitor.print(servoNumber);
-  Monitor.print(" - curve0: "); Monitor.print(curve0);
-  Monitor.print(" - curve1: "); Monitor.print(curve1);
-  Monitor.print(" - previousCurve: "); Monitor.println(previousCurve);
+  LOG_DEBUG("Servo: "); LOG_DEBUG(servoNumber);
+  LOG_DEBUG(" - curve0: "); LOG_DEBUG(curve0);
+  LOG_DEBUG(" - curve1: "); LOG_DEBUG(curve1);
+  LOG_DEBUG(" - previousCurve: "); LOG_DEBUGLN(previousCurve);
 };
 
 void MyServo::printInfoSet() {
-  Monitor.print("New curve:"); Monitor.println(previousCurve);
-  Monitor.print(" - direction: ");
-  Monitor.print(previousCurve & DIRECTION);
-  Monitor.print(" - previousCurve: ");
-  Monitor.println(previousCurve);
+  LOG_DEBUG("New curve:"); LOG_DEBUGLN(previousCurve);
+  LOG_DEBUG(" - direction: ");
+  LOG_DEBUG(previousCurve & DIRECTION);
+  LOG_DEBUG(" - previousCurve: ");
+  LOG_DEBUGLN(previousCurve);
 }
@@ -4,6 +4,18 @@
 // Author:    Aiko Pras
 // History:   2025/02/22 
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: curves are only decoded if needed; asymmetric curves are preloaded
+//            2026/10/16 agent: pins are taken from the tables in hardware.h
+//            2026/10/16 agent: start-up phase is completed by checkServo()
+//            2026/10/16 agent: servos request a slot from the power budget before they move
+//            2026/10/16 agent: pending-command slot, the latest command wins
+//            2026/10/16 agent: idle()
+//            2026/10/16 agent: the stored position selects curve0 or curve1
+//            2026/10/16 agent: curveChanged()
+//            2026/10/16 agent: intermediate positions via setAspect()
+//            2026/10/16 agent: reloadCVs()
+//            2026/10/16 agent: arrived()
+//            2026/10/16 agent: completing the start-up phase requires a slot from the power budget
 // 
 // Extends the ServoMoba class with some extra functionality that we need for this decoder
 // A maximum of 6 servo objects can be instantiated
@@ -17,21 +29,85 @@
 //
 // PreviousCurve
 // =============
-// As part of init(), also the last used curve (including the MSB = direction) is read from the
-// circular buffer (that is maintained at the end of the servo space), and stored in: previousCurve.
-// This data in previousCurve is needed to load the last used servo curve. In init(), this curve is 
-// used to determine the initial servo position (in microseconds) that must be written to the servo 
-// (writeMicroseconds) before we attach the servo. 
+// As part of init(), also the last position of the servo is read from the circular buffer (that is
+// maintained at the end of the servo space). The curve that belongs to that position (curve0 or 
+// curve1, including the MSB = direction) is stored in: previousCurve. This data in previousCurve is
+// needed to load the last used servo curve. In init(), this curve is used to determine the initial
+// servo position (in microseconds) that must be written to the servo (writeMicroseconds) before we
+// attach the servo. 
 //
 // New servo command
 // =================
-// Whenever a new DCC command is received, the (7LSB) from previousCurve and curve0 / curve1 
-// will be compared. 
-// If these are equal, then the curve is symmetric. In that case only the MSB needs to be changed.
-// If these are unequal, then the new curve must be loaded that belongs to the desired switch position.
-// Loading this new curve can be accomplished by loadCurve().
-// To subsequently move the servo, moveServoAlongCurve should be called.
+// Whenever a new DCC command is received, the curve that belongs to the desired switch position 
+// (curve0 or curve1) gets loaded by loadCurve(). To subsequently move the servo, moveServoAlongCurve
+// should be called.
+//
+// Loaded curve
+// ============
+// The Servo-TCA library holds a single decoded curve per servo, which is stretched by timeMultiplier
+// and scaled to the two tresholds. loadCurve() remembers which curve (7LSB) and timeMultiplier were
+// decoded last, and only calls the (10..50 us) library routine if one of these differs. For symmetric
+// curves only the MSB (direction) changes, so a new DCC command never needs to decode a curve.
+// For asymmetric curves, checkServo() decodes the curve for the opposite position as soon as the 
+// servo has stopped moving. Since the next command will always be for that opposite position, the 
+// curve is then already available and loading is again moved out of the path between DCC command
+// and servo movement. The decoded curve is invalidated if one of the tresholds is changed, or if the
+// EEPROM curve it was decoded from is changed (see curve_library.h).
 // 
+// Pending command
+// ===============
+// set() stores the requested position in a pending-command slot. If the servo is idle, the command is
+// executed immediately. If the servo is starting up, still moving or waiting for a power slot, the 
+// command is executed by checkServo() once the servo is ready. A new command overwrites the pending
+// one, so rapid toggles are coalesced and only the final requested position is executed.
+//
+// Arrival
+// =======
+// arrived() returns true once after the last set() command has been completed: the servo is at the
+// requested position, and no other command is pending. If the servo already was at the requested
+// position, arrived() returns true immediately. Main uses this to send the RS-Bus feedback after
+// the movement (see MOTION_FEEDBACK in hardware.h). A movement to an intermediate position is not
+// reported by itself. However, if setAspect() overrides a set() command that has not yet completed,
+// arrived() still returns true once the servo stops, and getPosition() then tells the end position
+// the servo came from. Otherwise the RS-Bus feedback would keep telling "moving".
+//
+// Power budget
+// ============
+// Before the servo starts moving, it requests a slot from the power budget (see power_budget.h).
+// If no slot is available, the command remains pending and checkServo() starts the movement 
+// as soon as a slot becomes available. The slot is released by checkServo() once the movement has 
+// been completed. Completing the start-up phase after reboot also requires a slot, since powering
+// the servo draws a similar current. That slot is kept for START_UP_POWER_TIME (see hardware.h), so
+// the servos are powered one after the other if MAX_MOVING_SERVOS is smaller than NUMBER_OF_SERVOS.
+//
+// Intermediate positions
+// ======================
+// Next to both end positions, each servo has NUMBER_OF_ASPECTS (4) intermediate positions, for example
+// for DKW lock bars, crossing gates or 3-way turnouts. These positions are stored in EEPROM behind 
+// the servo addresses (see hardware.h), as a value between 0 (Min) and 255 (Max). They are selected
+// via setAspect(), which is called for an RCN-213 extended accessory (signal aspect) command:
+// - aspect 0 and 1: the normal end positions, same as set(0) and set(1)
+// - aspect 2 .. NUMBER_OF_ASPECTS + 1: the intermediate positions 0 .. NUMBER_OF_ASPECTS - 1
+// The servo moves from wherever it is to the new position, along the curve for position 0 (CurveA).
+// For that purpose the tresholds are temporarily set to the pulse widths of the current and new 
+// position. These temporary tresholds remain set while the servo is parked at the intermediate
+// position, such that the curve and position of the library match the real position of the servo.
+// Once the servo has moved back to one of its end positions, checkServo() restores the normal 
+// tresholds and curve. A move that starts from an intermediate position always starts at the pulse
+// width of that position.
+// An intermediate position is not stored in EEPROM, and does not change the polarisation relay or
+// the RS-Bus feedback. After a reboot, the servo returns to the last stored end position.
+//
+// Changed CVs
+// ===========
+// If one of the CVs of this servo is changed (via PoM, SM or the configuration protocol), reloadCVs()
+// should be called. The new tresholds, curves, speed, invert flags and pulse / power settings are
+// applied as soon as the servo is not moving (immediately if the servo is idle). Thus servos can be 
+// calibrated without a reboot after every change. If the servo remains at the end of the same curve,
+// it keeps its position; if the tresholds changed and the pulse signal is continuous, the servo moves
+// directly to its new end position. A servo that is parked at an intermediate position stays there
+// (at the same fraction between the new Min and Max).
+//
 // Meaning of the bits within a curve byte
 // =======================================
 // The bits within the CVs and attributes that hold curves, have the following meaning:
@@ -54,15 +130,27 @@ class MyServo: public ServoMoba {
   public:
     void init(uint8_t servoNumber);         // In theory 0..7, in practice 0..1 
     void set( uint8_t servoPosition);       // 0 = diverging (red, -),  1 = straight (green, +)
+    void setAspect(uint8_t aspect);         // 0, 1: as set() / 2..: intermediate positions
+    void checkServo();                      // Should be called from main as frequent as possible
     void invertServoDirection();            // invert the servo direction by changing curvo0 and curve1
     void loadCurve(uint8_t curve);          // load a new curve from either EEPROM or PROGMEM
 
     bool getPosition();                     // 0 = diverging track, red, - / 1 = straight track, green, + 
+    uint8_t getRequestedPosition();         // As getPosition(), but includes a pending command
+    bool idle();                            // Nothing to do: not starting up, moving or waiting
+    bool arrived();                         // True (once) if the last set() command has been completed
 
     void configPulseSignal(                 // Configure all variables related to the pulse signal
       uint16_t initWidth);                  // using the related CV values 
     void configPowerSignal();               // Set the idle power values from CVs
 
+    void setTreshold1(uint16_t value);      // Sets the treshold, and invalidates the loaded curve
+    void setTreshold2(uint16_t value);      // Sets the treshold, and invalidates the loaded curve
+    void curveChanged(uint8_t slot);        // EEPROM curve changed: invalidates the loaded curve
+    void reloadCVs();                       // A servo CV changed: applies all CVs once the servo is idle
+
+    bool startingUp;                        // True until the start-up phase after reboot is completed
+
     uint8_t timeMultiplier;                 // 1..255 (20ms steps). Slows down servo movement
     bool invertPolarisationRelay;           // invert the relais from + is OFF to + is ON 
 
@@ -71,10 +159,21 @@ class MyServo: public ServoMoba {
     void attachMyServo();                   // Attaches the servo, if the corresponding PIN is defined
     void copyCurveCVs();                    // Copies the CVs for the Curves into curvo0 and curve1
     void setPolarisationRelay(bool pos);    // Sets the relay for the frog polarisation
+    void startUpPulseSignal();              // Determine the start-up level and time from the CVs 
     void pulseAfterReboot(                  // Aftrer reboot, set the pulse signal to a high or low level
       uint8_t level,                        // 0 = LOW (0V), 1 = HIGH (3,3 or 5V)
       uint8_t waitTime);                    // waitTime is in 20ms ticks
+    void completeStartUp();                 // Called by checkServo() once the start-up time has passed
+    void executePendingCommand();           // Executes the command in the pending-command slot
+    void startMovement(uint8_t position);   // Loads the curve, moves the servo and saves the position
+    void startAspectMovement();             // Moves from the current to the requested (intermediate) position
+    bool restorePending();                  // Back at an end position, but temporary tresholds still set
+    void restoreTresholds();                // Called once a movement with temporary tresholds is completed
+    void applyCVs();                        // Reads all CVs of this servo again, and applies them
+    uint16_t endPulseWidth(uint8_t curve);  // Pulse width (in us) at the end of a normal movement 
+    uint16_t aspectPulseWidth(uint8_t aspect); // Pulse width (in us) of an intermediate position
     void initPolarisationRelay();           // Sets the pin(s) for the frog polarisation relays as output
+    void preloadNextCurve();                // Loads the curve for the opposite position (asymmetric curves)
     void printInfoIni();                    // for debugging
     void printInfoSet();                    // for debugging
 
@@ -82,4 +181,29 @@ class MyServo: public ServoMoba {
     uint8_t curve0;                         // The curve we should use for switch position 0 (red)
     uint8_t curve1;                         // The curve we should use for switch position 1 (green)
     bool servoDirectionInverted;            // The servo direction was changed by invertServoDirection()
+    PORT_t* relayPort;                      // PORT registers of the polarisation relay pin
+    uint8_t relayMask;                      // Bit mask of the relay pin within that PORT (0 = no relay)
+
+    uint8_t loadedCurve = NO_CURVE;         // Curve (7LSB) that is currently decoded by the library
+    uint8_t loadedMultiplier;               // timeMultiplier that was used to decode that curve
+    bool preloadPending;                    // After the movement, load the curve for the opposite position
+
+    uint16_t initialPulseWidth;             // Pulse width (in us) to start with after start-up
+    unsigned long startUpTime;              // Time (in ms) the start-up phase started / was completed
+    uint16_t startUpDuration;               // Duration (in ms) of the start-up phase
+
+    bool commandPending;                    // Pending-command slot: a new position has been requested
+    uint8_t requestedPosition;              // The last requested position (latest wins)
+    bool holdsPowerSlot;                    // The servo got a slot from the power budget (moving / start-up)
+
+    uint8_t requestedAspect = NO_ASPECT;    // Pending-command slot: requested intermediate position
+    uint8_t currentAspect = NO_ASPECT;      // Intermediate position of the servo (NO_ASPECT: at an end)
+    bool temporaryTresholds;                // The tresholds are set for a move between two positions
+    uint16_t normalTreshold1;               // The tresholds to restore after such move
+    uint16_t normalTreshold2;
+    uint8_t curveAfterMove;                 // End position curve the servo left (or moves to) in such move
+    bool reloadPending;                     // CVs have changed, and should be applied once idle
+    bool arrivalPending;                    // set() was called, but arrived() did not yet return true
+    static const uint8_t NO_ASPECT = 0xFF;  // The servo is at (or moves to) one of its end positions
+    static const uint8_t NO_CURVE = 0xFF;   // loadedCurve value if no (valid) curve is decoded
 };
@@ -0,0 +1,48 @@
+//*****************************************************************************************************
+//
+// File:      power_budget.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+// 
+// To get a high-level understanding of what this code is supposed to do, see power_budget.h.
+//
+//******************************************************************************************************
+#include "power_budget.h"
+
+// Instantiate the object for the power budget
+PowerBudget powerBudget;
+
+
+bool PowerBudget::request(uint8_t servoNumber) {
+  // A slot is granted if there is a free slot, and no other servo has been waiting longer
+  bool slotAvailable = (movingServos < MAX_MOVING_SERVOS);
+  if (slotAvailable && ((queueLength == 0) || (queue[0] == servoNumber))) {
+    cancel(servoNumber);                            // If we were queued, we are no longer
+    movingServos++;
+    return true;
+  }
+  // No slot available (yet). Add this servo to the end of the queue, if it is not queued yet
+  for (uint8_t i = 0; i < queueLength; i++) 
+    if (queue[i] == servoNumber) return false;
+  queue[queueLength] = servoNumber;
+  queueLength++;
+  return false;
+};
+
+
+void PowerBudget::release() {
+  if (movingServos > 0) movingServos--;
+};
+
+
+void PowerBudget::cancel(uint8_t servoNumber) {
+  // Remove the servo from the queue, and shift all servos that were behind it one place forward
+  uint8_t j = 0;
+  for (uint8_t i = 0; i < queueLength; i++) {
+    if (queue[i] != servoNumber) {
+      queue[j] = queue[i];
+      j++;
+    };
+  };
+  queueLength = j;
+};
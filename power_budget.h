@@ -0,0 +1,43 @@
+//*****************************************************************************************************
+//
+// File:      power_budget.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: cancel()
+// 
+// Limits the number of servos that may move (and thus draw their start-up current) simultaneously. 
+//
+// If a route is set, several accessory commands arrive shortly after each other. Without a limit,
+// all servos would start moving (and their enable pins would power up) at nearly the same time. The
+// resulting inrush current may be too much for weaker boosters or power supplies.
+// 
+// Before a servo starts moving, MyServo requests a slot from the power budget. If the number
+// of servos that are already moving is below MAX_MOVING_SERVOS (see hardware.h), the request is
+// granted. Otherwise the servo is placed in a (FIFO) queue. As soon as a moving servo has completed
+// its movement, MyServo::checkServo() releases its slot, after which the first servo in the queue
+// gets the slot the next time its checkServo() calls request(). 
+//
+// If MAX_MOVING_SERVOS equals NUMBER_OF_SERVOS, requests are always granted.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "hardware.h"
+
+
+class PowerBudget {
+  public:
+    bool request(uint8_t servoNumber);          // true: the servo may start moving / false: queued
+    void release();                             // should be called once the movement is completed
+    void cancel(uint8_t servoNumber);           // removes the servo from the queue
+
+  private:
+    uint8_t movingServos;                       // Number of servos that currently hold a slot
+    uint8_t queue[NUMBER_OF_SERVOS];            // Servos that wait for a slot, in order of arrival
+    uint8_t queueLength;                        // Number of servos in the queue
+};
+
+
+//******************************************************************************************************
+// The object is defined in power_budget.cpp and may be used by myServo 
+extern PowerBudget powerBudget;
@@ -0,0 +1,99 @@
+//*****************************************************************************************************
+//
+// File:      routes.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: the boot counter is no longer stored in EEPROM
+//            2026/10/16 agent: route CVs end at the servo addresses
+//            2026/10/16 agent: routes with invalid triggers or steps are not used
+//            2026/10/16 agent: repeated commands do not restart a running route
+// 
+// To get a high-level understanding of what this code is supposed to do, see routes.h.
+//
+// To avoid EEPROM reads for every accessory command, the trigger addresses of all routes are kept 
+// in RAM. The steps themselves are read from EEPROM while the route is executed.
+//
+//******************************************************************************************************
+#include "routes.h"
+#include <EEPROM.h>
+
+// The servo is moved and its RS-Bus feedback is sent by main
+extern void setServo(uint8_t servoNumber, uint8_t position);
+
+// Instantiate the object for the routes
+Routes routes;
+
+
+void Routes::init() {
+  // A route is only used if its trigger address is valid, and all its steps refer to existing servos.
+  // Otherwise its trigger is set to 0, which never matches an accessory command.
+  uint16_t index = START_INDEX_ROUTES;
+  for (uint8_t i = 0; i < NUMBER_OF_ROUTES; i++) {
+    uint8_t low = EEPROM.read(index);
+    uint8_t high = EEPROM.read(index + 1);
+    uint16_t address = low + ((high & 0x0F) * 256);
+    triggers[i] = 0;
+    if (((high & 0x70) == 0) && (address >= 1) && (address <= 2048) && validSteps(index + 2)) {
+      triggers[i] = address;
+      if (high & 0x80) triggers[i] |= 0x8000;
+    }
+    index = index + ROUTE_SIZE;
+  };
+};
+
+
+bool Routes::validSteps(uint16_t index) {
+  for (uint8_t step = 0; step < ROUTE_STEPS; step++) {
+    uint8_t servoByte = EEPROM.read(index + (step * 2));
+    if (servoByte == ROUTE_END) return true;
+    if ((servoByte & 0x7F) >= NUMBER_OF_SERVOS) return false;
+  };
+  return true;
+};
+
+
+void Routes::cvChanged(uint16_t cvNumber) {
+  if ((cvNumber >= START_INDEX_ROUTES) && (cvNumber < START_INDEX_SERVO_ADDRESSES)) init();
+};
+
+
+bool Routes::start(uint16_t address, uint8_t position) {
+  if ((address == 0) || (address > 2048)) return false;
+  uint16_t trigger = address;
+  if (position) trigger |= 0x8000;
+  for (uint8_t i = 0; i < NUMBER_OF_ROUTES; i++) {
+    if (triggers[i] == trigger) {
+      // Command stations repeat accessory commands. A repeat should not restart the running route
+      if (running && (runningRoute == i)) return true;
+      runningRoute = i;
+      stepIndex = START_INDEX_ROUTES + (i * ROUTE_SIZE) + 2;
+      stepsLeft = ROUTE_STEPS;
+      nextStepTime = millis();
+      running = true;
+      return true;
+    };
+  };
+  return false;
+};
+
+
+void Routes::check() {
+  if (!running) return;
+  if ((long)(millis() - nextStepTime) < 0) return;
+  uint8_t servoByte = EEPROM.read(stepIndex);
+  uint8_t waitTime = EEPROM.read(stepIndex + 1);
+  if (servoByte == ROUTE_END) {
+    running = false;
+    return;
+  }
+  uint8_t servoNumber = servoByte & 0x7F;
+  if (servoNumber >= NUMBER_OF_SERVOS) {            // The route was changed while it was running
+    running = false;
+    return;
+  }
+  setServo(servoNumber, servoByte >> 7);
+  nextStepTime = millis() + (waitTime * 20);
+  stepIndex = stepIndex + 2;
+  stepsLeft--;
+  if (stepsLeft == 0) running = false;
+};
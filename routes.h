@@ -0,0 +1,68 @@
+//*****************************************************************************************************
+//
+// File:      routes.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: routes with invalid triggers or steps are not used
+//            2026/10/16 agent: repeated commands do not restart a running route
+// 
+// Routes allow a single accessory command to move several servos, one after the other.
+//
+// Without routes, setting a route requires a DCC accessory packet for every switch in that route,
+// which is in addition repeated by the command station. With routes stored in the decoder, a single 
+// accessory address (and position) starts a list of steps. Each step moves one servo to a position,
+// and waits a certain time before the next step is executed.
+//
+// The routes are stored in EEPROM, behind the curves (see hardware.h). Since the EEPROM index equals
+// the CV number, routes can be programmed via PoM or SM. Each route takes ROUTE_SIZE (16) bytes:
+//
+// Byte 0: Trigger address - low order byte 
+// Byte 1: Bits 0..3: Trigger address - high order bits
+//         Bit 7: Trigger position (0 = diverging / red / -, 1 = straight / green / +)
+// Byte 2 + 2 * step:  Bits 0..6: servo number (0 = first servo)
+//                     Bit 7: position the servo should move to
+//                     The value 255 ends the route
+// Byte 3 + 2 * step:  Time to wait before the next step is executed, in 20 ms ticks (0..255)
+//
+// The trigger address is the switch address, as used by handhelds (1..2048). A route with trigger
+// address 0, or a trigger address above 2048 (such as after the EEPROM is erased) is not used.
+// Each route has a maximum of 7 steps. A route that has a step with a servo number this board does
+// not have (or bits 4..6 of byte 1 set) is not used at all.
+//
+// Routes are started by start(), which is called from the main loop for every accessory command.
+// The steps are executed by check(), which should be called from the main loop as often as possible.
+// Routes never block: a step only sets the new servo position; the servo moves under control of 
+// checkServo() (and the power budget). If a route is started while another route is still running,
+// the running route is stopped. Repeats of the command that started the running route (command
+// stations send every accessory command several times) are ignored.
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "hardware.h"
+
+#define ROUTE_STEPS            ((ROUTE_SIZE - 2) / 2)
+#define ROUTE_END              255                  // Value of the servo byte that ends a route
+
+
+class Routes {
+  public:
+    void init();                                    // Copies the trigger addresses from EEPROM to RAM
+    void cvChanged(uint16_t cvNumber);              // Should be called after a CV is changed via PoM / SM
+    bool start(uint16_t address, uint8_t position); // Returns true if this command starts a route
+    void check();                                   // Should be called from main as frequent as possible
+    bool running;                                   // A route is being executed
+
+  private:
+    bool validSteps(uint16_t index);                // All steps, starting at this EEPROM index, are valid
+    uint16_t triggers[NUMBER_OF_ROUTES];            // Trigger address (bits 0..11) and position (bit 15)
+    uint8_t runningRoute;                           // The route that is being executed (if running)
+    uint16_t stepIndex;                             // EEPROM index of the next step
+    uint8_t stepsLeft;                              // Number of steps that remain in the running route
+    unsigned long nextStepTime;                     // Time (in ms) at which the next step may be executed
+};
+
+
+//******************************************************************************************************
+// The object is defined in routes.cpp and used by main
+extern Routes routes;
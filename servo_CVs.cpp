@@ -4,25 +4,75 @@
 // Author:    Aiko Pras
 // History:   2025/03/22 
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: RAM copy of the servo CVs, with write-through to EEPROM
+//            2026/10/16 agent: routes are cleared with the other servo specific values
+//            2026/10/16 agent: no boot counter in EEPROM
+//            2026/10/16 agent: servo CVs are written via the EEPROM write queue
+//            2026/10/16 agent: servo addresses are cleared with the other servo specific values
+//            2026/10/16 agent: ReadServoAspect()
+//            2026/10/16 agent: read the servo CVs through the EEPROM write queue
+//            2026/10/16 agent: clear the circular buffer via storedPositions
+//            2026/10/16 agent: store the EEPROM layout version
+//            2026/10/16 agent: UpgradeServoValuesInEEPROM() keeps the servo CVs and curves
 // 
 // Read, write and initialise the servo specific CVs.
 //
+// RAM copy
+// ========
+// The servo specific CVs are read often: during init(), when the pulse and power signals are
+// configured, and from the configuration loop. To avoid EEPROM accesses for all these reads, a copy of 
+// the complete servo CV block (NUMBER_OF_SERVO_CVS bytes per servo, see hardware.h) is kept in RAM.
+// This copy is loaded once by LoadServoCVs(), which should be called from setup() before the servos
+// are initialised. ReadServoCV() reads from this copy only. WriteServoCV() writes through: it updates
+// the RAM copy as well as the EEPROM. CVs that are changed via PoM or SM are written into EEPROM by
+// the AP_DCC_Decoder_Core library; after such message ReloadServoCV() should be called to update the
+// RAM copy.
+// Since WriteServoCV() places the bytes in the EEPROM write queue (see eeprom_writer.h), the EEPROM 
+// itself may still hold an older value. Therefore LoadServoCVs() and ReloadServoCV() read via
+// eepromWriter.read(), which returns the queued value if the byte has not yet been written.
+//
 //******************************************************************************************************
 #include "servo_CVs.h"
 #include "servo_position.h"
+#include "eeprom_writer.h"
 #include <AP_DCC_Decoder_Core.h>     // To use cvValues read and write 
 #include <EEPROM.h>
 
 
+// The RAM copy of the servo specific CVs
+uint8_t servoCVs[NUMBER_OF_SERVOS][NUMBER_OF_SERVO_CVS];
+
+
+void LoadServoCVs() {
+  uint16_t CvIndex = START_INDEX_SERVO_CVS;
+  for (uint8_t servo = 0; servo < NUMBER_OF_SERVOS; servo++) {
+    for (uint8_t CV = 0; CV < NUMBER_OF_SERVO_CVS; CV++) {
+      servoCVs[servo][CV] = eepromWriter.read(CvIndex);
+      CvIndex++;
+    };
+  };
+};
+
+
+void ReloadServoCV(uint16_t cvNumber) {
+  // The CV number equals the EEPROM index. Ignore CVs outside the servo specific CV block
+  if ((cvNumber < START_INDEX_SERVO_CVS) || (cvNumber >= START_INDEX_SERVO_CURVES)) return;
+  uint16_t offset = cvNumber - START_INDEX_SERVO_CVS;
+  servoCVs[offset / NUMBER_OF_SERVO_CVS][offset % NUMBER_OF_SERVO_CVS] = eepromWriter.read(cvNumber);
+};
+
+
 uint8_t ReadServoCV(uint8_t servo, uint8_t CV) {
-  uint16_t CvIndex = START_INDEX_SERVO_CVS + (servo * NUMBER_OF_SERVO_CVS) + CV;
-  return EEPROM.read(CvIndex);
+  return servoCVs[servo][CV];
 };
 
 
 void WriteServoCV(uint8_t servo, uint8_t CV, uint8_t value) {
   uint16_t CvIndex = START_INDEX_SERVO_CVS + (servo * NUMBER_OF_SERVO_CVS) + CV;
-  if (servo < NUMBER_OF_SERVOS) EEPROM.update(CvIndex, value); 
+  if (servo < NUMBER_OF_SERVOS) {
+    servoCVs[servo][CV] = value;
+    eepromWriter.write(CvIndex, value); 
+  };
 };
 
 
@@ -41,6 +91,11 @@ uint16_t ReadServoMax(uint8_t servo) {
   return valueHigh * 256 + valueLow;
 };
 
+uint8_t ReadServoAspect(uint8_t servo, uint8_t aspect) {
+  // The intermediate positions are not part of the servo CV block, and thus not cached in RAM
+  return eepromWriter.read(START_INDEX_ASPECTS + (servo * NUMBER_OF_ASPECTS) + aspect);
+};
+
 void WriteServoMin(uint8_t servo, uint16_t value) {
   uint8_t valueLow = value % 256;
   uint8_t valueHigh = value / 256;
@@ -78,10 +133,13 @@ void WriteServoMax(uint8_t servo, uint16_t value) {
 // PowerOffAfter       = 17;  // In 20ms ticks
 
 
+static void InitValuesBehindCurves();             // Routes, servo addresses, aspects and positions
+
+
 //******************************************************************************************************
 void CreateDefaultServoValuesInEEPROM() {
-  // Step 1: Store the number of servos in the CV proeceeding the first servo CVs
-  cvValues.write((START_INDEX_SERVO_CVS - 1), NUMBER_OF_SERVOS);
+  // Step 1: Store the number of servos and the layout version in the CV proeceeding the first servo CVs
+  // This is done last (see step 7), such that a reset during the initialisation restarts it.
   // Step 2: Set the CV values for upto 8 servos
   for (uint8_t i = 0; i < NUMBER_OF_SERVOS; i++) {
     WriteServoMin(i, 1300);                         // in us 
@@ -107,9 +165,39 @@ void CreateDefaultServoValuesInEEPROM() {
   for (uint16_t i = START_INDEX_SERVO_CURVES; i < endIndexServoCurves; i++) {
     EEPROM.update(i, 0);
   }  
-  // Step 4: Clear the circular buffer (all values become 255)
-  // Instead of writing such code again, we use the existing routine in servo_positions
-  // To call that routine, we need to declare a local object first
-  ServoPosition circularBuffer;
-  circularBuffer.clearEEPROMCircularBufferValues();
+  // Step 4-7: Initialise the remaining parts of the EEPROM
+  InitValuesBehindCurves();
+};
+
+
+void UpgradeServoValuesInEEPROM() {
+  // Called if the EEPROM has the layout of another software version, but the same number of servos.
+  // The servo CVs and curves (including their calibrated tresholds) are kept, since their place did
+  // not change. Only the parts behind the curves, which were added or moved, are initialised.
+  InitValuesBehindCurves();
+};
+
+
+static void InitValuesBehindCurves() {
+  // Step 4: Clear the routes (all values become 0, thus no route is used)
+  for (uint16_t i = START_INDEX_ROUTES; i < START_INDEX_SERVO_ADDRESSES; i++) {
+    EEPROM.update(i, 0);
+  }  
+  // Step 4a: Clear the servo addresses (0 = the servo uses the decoder address only)
+  for (uint16_t i = START_INDEX_SERVO_ADDRESSES; i < START_INDEX_ASPECTS; i++) {
+    EEPROM.update(i, 0);
+  }  
+  // Step 4b: All intermediate positions are halfway between Min and Max
+  for (uint16_t i = START_INDEX_ASPECTS; i < START_INDEX_POSITIONS; i++) {
+    EEPROM.update(i, 128);
+  }  
+  // Step 5: Clear the circular buffer (all values become 255)
+  // This must be done via the storedPositions object itself: it was constructed (at start-up) from 
+  // the old EEPROM contents, and should forget the newest record and phase it found there.
+  storedPositions.clearEEPROMCircularBufferValues();
+  // Step 6: The servo CVs were written via the EEPROM write queue. Write all of them now, before the
+  // decoder continues with the (new) EEPROM contents
+  eepromWriter.flush();
+  // Step 7: The EEPROM now has the layout of this software version
+  cvValues.write(INDEX_EEPROM_LAYOUT, EEPROM_LAYOUT);
 };
@@ -4,6 +4,9 @@
 // Author:    Aiko Pras
 // History:   2025/03/22 
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: RAM copy of the servo CVs, with write-through to EEPROM
+//            2026/10/16 agent: ReadServoAspect()
+//            2026/10/16 agent: UpgradeServoValuesInEEPROM()
 // 
 // As opposed to some of my earlier decoders, the servo decoder needs more CVs to allow the user
 // to change several aspects of the servo's behavior. Therefore the CV space is divided into two parts:
@@ -114,10 +117,14 @@ const uint8_t PowerOffAfter       = 17;  // In 20ms ticks
 
 
 void CreateDefaultServoValuesInEEPROM();
+void UpgradeServoValuesInEEPROM();                // New layout version: keeps the servo CVs and curves
+void LoadServoCVs();                              // Copies all servo specific CVs from EEPROM into RAM
+void ReloadServoCV(uint16_t cvNumber);            // Should be called after a CV is changed via PoM / SM
 
 uint8_t ReadServoCV(uint8_t servo, uint8_t CV);
 uint16_t ReadServoMin(uint8_t servo);
 uint16_t ReadServoMax(uint8_t servo);
+uint8_t ReadServoAspect(uint8_t servo, uint8_t aspect); // Intermediate position 0..255 (Min..Max)
 
 void WriteServoCV(uint8_t servo, uint8_t CV, uint8_t value);
 void WriteServoMin(uint8_t servo, uint16_t value);
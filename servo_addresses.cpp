@@ -0,0 +1,42 @@
+//*****************************************************************************************************
+//
+// File:      servo_addresses.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 agent: servo address CVs end at the intermediate positions
+// 
+// To get a high-level understanding of what this code is supposed to do, see servo_addresses.h.
+//
+//******************************************************************************************************
+#include "servo_addresses.h"
+#include <EEPROM.h>
+
+// Instantiate the object for the servo addresses
+ServoAddresses servoAddresses;
+
+
+void ServoAddresses::init() {
+  for (uint16_t i = 0; i < sizeof(bitmap); i++) bitmap[i] = 0;
+  uint16_t index = START_INDEX_SERVO_ADDRESSES;
+  for (uint8_t servoNr = 0; servoNr < NUMBER_OF_SERVOS; servoNr++) {
+    uint16_t address = EEPROM.read(index) + (EEPROM.read(index + 1) * 256);
+    if ((address == 0) || (address > MAX_SWITCH_ADDRESS)) address = 0;
+      else bitmap[(address - 1) / 8] |= (1 << ((address - 1) % 8));
+    addresses[servoNr] = address;
+    index = index + 2;
+  };
+};
+
+
+void ServoAddresses::cvChanged(uint16_t cvNumber) {
+  if ((cvNumber >= START_INDEX_SERVO_ADDRESSES) && (cvNumber < START_INDEX_ASPECTS)) init();
+};
+
+
+uint8_t ServoAddresses::find(uint16_t address) {
+  if ((address == 0) || (address > MAX_SWITCH_ADDRESS)) return NO_SERVO;
+  if (!(bitmap[(address - 1) / 8] & (1 << ((address - 1) % 8)))) return NO_SERVO;
+  for (uint8_t servoNr = 0; servoNr < NUMBER_OF_SERVOS; servoNr++) 
+    if (addresses[servoNr] == address) return servoNr;
+  return NO_SERVO;
+};
@@ -0,0 +1,50 @@
+//*****************************************************************************************************
+//
+// File:      servo_addresses.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+// 
+// Each servo may get an accessory (switch) address of its own.
+//
+// Normally the servos use consecutive turnouts of the decoder address (see initTurnoutMap() in the
+// main sketch). On some layouts, however, each servo should be controlled via its own accessory 
+// address, which is not related to the decoder address, nor to the addresses of the other servos.
+// For that purpose there are two CVs per servo, stored behind the routes (see hardware.h):
+//
+// Byte 0: Accessory address - low order byte 
+// Byte 1: Accessory address - high order byte
+//
+// The address is the switch address, as used by handhelds (1..2048). An address of 0, or an address
+// above 2048 (such as after the EEPROM is erased) is not used. The servo still reacts to its turnout
+// of the decoder address as well. If several servos have the same address, only the first one moves;
+// use a route to move several servos with one command.
+//
+// Since every accessory command on the layout has to be checked against these addresses, the main
+// loop should be able to reject commands for other decoders quickly. Therefore a bitmap with one bit
+// for each of the 2048 addresses is kept in RAM (256 bytes). find() tests a single bit, and only if
+// that bit is set, it searches the servo that belongs to this address. 
+//
+//******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "hardware.h"
+
+#define NO_SERVO               0xFF                 // find(): no servo uses this address
+#define MAX_SWITCH_ADDRESS     2048
+
+
+class ServoAddresses {
+  public:
+    void init();                                    // Copies the addresses from EEPROM to RAM
+    void cvChanged(uint16_t cvNumber);              // Should be called after a CV is changed via PoM / SM
+    uint8_t find(uint16_t address);                 // Returns the servo number, or NO_SERVO
+
+  private:
+    uint8_t bitmap[MAX_SWITCH_ADDRESS / 8];         // Bit (address - 1) is set if a servo uses it
+    uint16_t addresses[NUMBER_OF_SERVOS];           // The address of each servo (0 = not used)
+};
+
+
+//******************************************************************************************************
+// The object is defined in servo_addresses.cpp and may be used by main 
+extern ServoAddresses servoAddresses;
@@ -4,104 +4,197 @@
 // Author:    Aiko Pras
 // History:   2025/03/22 
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: log-structured journal instead of a fixed slot per boot
+//            2026/10/16 agent: deferred writes, with a flush on power failure
+//            2026/10/16 agent: one bit per servo instead of one byte
+//            2026/10/16 agent: optional timing of position saves
+//            2026/10/16 agent: records are written via the EEPROM write queue
+//            2026/10/16 agent: reload()
+//            2026/10/16 agent: messages via the non-blocking logger
+//            2026/10/16 agent: flush the EEPROM write queue before the buffer is cleared
+//            2026/10/16 agent: flush the EEPROM write queue on power failure, also without new positions
+//            2026/10/16 agent: a torn write of the first slot does not lose the newest record
 // 
 // To get a high-level understanding of what this code is supposed to do, see servo_position.h.
 //
-// To make the code easier to read (and thus reduce the chance we make mistakes), we maintain
-// an array of (16 bit) indexes into the EEPROM that point to the EEPROM bytes that contain the values
-// for the servo positions.  
-//
-// incrementNumberOfBoots() is called only once, when the first servo movement takes place.
+// The positions of all servos are kept in RAM (servoPositions[]). After a change, a new record with
+// all positions is written into the next slot of the circular buffer. This is done by check(), after
+// POSITION_WRITE_DELAY or on power failure. 
 //
 //******************************************************************************************************
 #include "servo_position.h"
 #include <EEPROM.h>
+#include "eeprom_writer.h"                              // Queued EEPROM writes
+#include "logger.h"                                     // Non-blocking messages on the serial monitor
+#include "timing.h"                                     // Optional measurement of execution times
+
+#define PHASE            0x80                           // Bit 7 of byte 0 of a record
+#define ERASED           0x40                           // Bit 6 of byte 0: no valid record
 
 // Instantiate the object for the stored positions
 ServoPosition storedPositions;
 
+// Set by the VLM interrupt if the supply voltage drops
+volatile bool powerFailing = false;
+
 
 ServoPosition::ServoPosition() {                        // Constructor. Called at start up
-  firstCall = true;                                     
-  numberOfBoots = EEPROM.read(EEPROM_BOOTS_INDEX);      // 1 .. SIZE_CIRCULAR_BUFFER
-  if (numberOfBoots == 0) numberOfBoots = 1;            // the EEPROM is erased, and nothing is stored yet.
-  if (numberOfBoots == 255) numberOfBoots = 1;          // the EEPROM is new, and nothing is stored yet.
-  calculateservoPositions();                            // the index positions point to the old values
+  unsaved = false;
+  findNewestRecord();
 };
 
 
-uint16_t ServoPosition::getIndex(uint8_t servoNumber) { 
-  // Determines where the position for a specific servo is stored
-  // numberOfBoots >= 1 / servoNumber = 0...
-  uint16_t index = EEPROM_BOOTS_INDEX + numberOfBoots + servoNumber;    // EEPROM location for this servo
-  if (index >= EEPROM_SIZE) index = index - SIZE_CIRCULAR_BUFFER;       // Wrap around
-  return index;
+uint16_t ServoPosition::getIndex(uint8_t record) { 
+  return START_INDEX_POSITIONS + (record * POSITION_RECORD_SIZE);
 };
 
 
-void ServoPosition::incrementNumberOfBoots() {          // Will be called after first setPosition
-  firstCall = false;                                    // make sure we are only called once!
-  // We have to move all servo positions one index to the right
-  // We first move the last (right most); the first position is moved last.
-  // Note that the for statement counts down, and the last servoNr is 1 (not 0)
-  for (uint8_t servoNr = NUMBER_OF_SERVOS; servoNr > 0; servoNr--) 
-    EEPROM.update(getIndex(servoNr), EEPROM.read(getIndex(servoNr -1)));
-  if (numberOfBoots == SIZE_CIRCULAR_BUFFER)            // Overflow??
-    numberOfBoots = 1;                                  // then wrap around
-    else numberOfBoots++;                               // else move the buffer index one byte further
-  EEPROM.update(EEPROM_BOOTS_INDEX, numberOfBoots);     // Save the new numberOfBoots 
-  calculateservoPositions();                            // The index positions point now to the new values 
+void ServoPosition::findNewestRecord() {
+  // Start with the first slot, and continue as long as the records have the same phase.
+  // If the first slot is erased, but the second slot holds a record, the write of the first record of
+  // a new pass was interrupted. The newest record is then the last one of the previous pass, which is 
+  // found by starting the scan at the second slot.
+  uint8_t first = 0;
+  uint8_t value = EEPROM.read(getIndex(0));
+  if (value & ERASED) {
+    value = EEPROM.read(getIndex(1));
+    first = 1;
+  }
+  if (value & ERASED) {                                 // Nothing is stored yet.
+    newestRecord = NUMBER_OF_POSITION_RECORDS - 1;      // Such that the first record is written in slot 0
+    phase = PHASE;                                      // Such that the first record gets phase 0
+    for (uint8_t servoNr = 0; servoNr < NUMBER_OF_SERVOS; servoNr++) servoPositions[servoNr] = 0;
+    return;
+  };
+  newestRecord = first;
+  phase = value & PHASE;
+  for (uint8_t record = first + 1; record < NUMBER_OF_POSITION_RECORDS; record++) {
+    value = EEPROM.read(getIndex(record));
+    if ((value & ERASED) || ((value & PHASE) != phase)) break;
+    newestRecord = record;
+  };
+  // Unpack the positions of the newest record
+  uint16_t index = getIndex(newestRecord);
+  uint8_t bits = EEPROM.read(index);
+  for (uint8_t servoNr = 0; servoNr < NUMBER_OF_SERVOS; servoNr++) {
+    if (servoNr == 6) bits = EEPROM.read(index + 1);
+    uint8_t bit = (servoNr < 6) ? servoNr : servoNr - 6;
+    servoPositions[servoNr] = (bits >> bit) & 1;
+  };
 };
 
 
-void ServoPosition::calculateservoPositions() {
-  // servoNr 0 .. (NUMBER_OF_SERVOS - 1)
-  uint8_t value;
+void ServoPosition::saveServoPosition(uint8_t number, uint8_t value) {
+  servoPositions[number] = value;
+  unsaved = true;
+  lastChange = millis();
+  if (POSITION_WRITE_DELAY == 0) writeRecord();
+};
+
+
+void ServoPosition::check() {
+  // On power failure, write the unsaved positions and all other queued bytes (such as CVs) immediately
+  if (powerFailing) {
+    powerFailing = false;
+    if (unsaved) writeRecord();
+    eepromWriter.flush();                               // Don't wait for the main loop
+    return;
+  }
+  if (!unsaved) return;
+  if ((millis() - lastChange) >= POSITION_WRITE_DELAY) writeRecord();
+};
+
+
+void ServoPosition::flush() {
+  if (unsaved) writeRecord();
+};
+
+
+void ServoPosition::writeRecord() {
+  TIMING_START(saveStart);
+  // Move to the next slot. If we continue with the first slot, the phase flips.
+  newestRecord++;
+  if (newestRecord >= NUMBER_OF_POSITION_RECORDS) newestRecord = 0;
+  if (newestRecord == 0) phase ^= PHASE;
+  // Pack the positions. Byte 0, which holds the phase, is written last.
+  uint8_t byte0 = phase;
+  uint8_t byte1 = 0;
   for (uint8_t servoNr = 0; servoNr < NUMBER_OF_SERVOS; servoNr++) {
-    value = EEPROM.read(getIndex(servoNr));
-    if (value == 255) value = 0;                        // EEPROM has not yet been initialsed
-    servoPositions[servoNr] = value;
+    if (!servoPositions[servoNr]) continue;
+    if (servoNr < 6) byte0 |= (1 << servoNr);
+      else byte1 |= (1 << (servoNr - 6));
   };
+  uint16_t index = getIndex(newestRecord);
+  if (POSITION_RECORD_SIZE == 2) eepromWriter.write(index + 1, byte1);
+  eepromWriter.write(index, byte0);
+  unsaved = false;
+  TIMING_STOP(SavePosition, saveStart);
+  // The lines below are for debugging only
+  // LOG_DEBUG("writeRecord. record: "); LOG_DEBUG(newestRecord);
+  // LOG_DEBUG(" - value: "); LOG_DEBUGLN(byte0, BIN);
 };
 
 
-void ServoPosition::saveServoPosition(uint8_t number, uint8_t value) {
-  if (firstCall) incrementNumberOfBoots();
-  EEPROM.update(getIndex(number), value);
-  // The lines below are for debugging only
-  // Monitor.print("saveServoPosition. servo: "); Monitor.print(number);
-  // Monitor.print(" - index: "); Monitor.print(getIndex(number));
-  // Monitor.print(" - value: "); Monitor.println(value);
+//******************************************************************************************************
+// Power failure detection
+// The VLM level is set to 25% above the BOD level. The interrupt is raised once the supply voltage 
+// drops below that level. The interrupt routine only sets a flag; the write itself is performed by
+// check(), which is called from the main loop. Since the interrupt also ends idle sleep, this happens
+// within microseconds.
+void ServoPosition::initPowerFailDetection() {
+  #if POWER_FAIL_FLUSH
+    BOD.VLMCTRLA = BOD_VLMLVL_25ABOVE_gc;
+    BOD.INTCTRL = BOD_VLMIE_bm | BOD_VLMCFG_BELOW_gc;
+  #endif
+};
+
+
+#if POWER_FAIL_FLUSH
+ISR(BOD_VLM_vect) {
+  BOD.INTFLAGS = BOD_VLMIF_bm;                          // Clear the interrupt flag
+  powerFailing = true;
+}
+#endif
+
+
+void ServoPosition::reload() {
+  // The positions in RAM are replaced by the newest record in EEPROM. Unsaved positions are lost.
+  eepromWriter.flush();
+  unsaved = false;
+  findNewestRecord();
 };
 
 
 void ServoPosition::clearEEPROMCircularBufferValues() {
-  uint16_t i = EEPROM_BOOTS_INDEX;
+  // Queued record bytes would otherwise be written after the buffer has been cleared
+  eepromWriter.flush();
+  uint16_t i = START_INDEX_POSITIONS;
   while (i < EEPROM_SIZE) {
     EEPROM.update(i, 255);
     i++;
   };
-  firstCall = true; 
-  numberOfBoots = 1;                                    // the EEPROM is new, and nothing is stored yet.
-  calculateservoPositions();                            // initialise these
+  unsaved = false;
+  findNewestRecord();                                   // the EEPROM is new, and nothing is stored yet.
 }
 
 
 //******************************************************************************************************
 void ServoPosition::printEEPROM() {                     // For debugging
-  // Monitor.print("");
-  Monitor.print("EEPROM_SIZE: ");
-  Monitor.println(EEPROM_SIZE);
-  Monitor.print("EEPROM Boots index: ");
-  Monitor.println(EEPROM_BOOTS_INDEX);
-  Monitor.print("Number of Boots: ");
-  Monitor.println(numberOfBoots);
-  Monitor.print("indexPosition 0: ");
-  Monitor.println(getIndex(0));
-  Monitor.print("indexPosition 1: ");
-  Monitor.println(getIndex(1));
-  Monitor.print("Servo0 position: ");
-  Monitor.println(servoPositions[0]);
-  Monitor.print("Servo1 position: ");
-  Monitor.println(servoPositions[1]);
+  // LOG_DEBUG("");
+  LOG_DEBUG("EEPROM_SIZE: ");
+  LOG_DEBUGLN(EEPROM_SIZE);
+  LOG_DEBUG("Start index positions: ");
+  LOG_DEBUGLN(START_INDEX_POSITIONS);
+  LOG_DEBUG("Number of records: ");
+  LOG_DEBUGLN(NUMBER_OF_POSITION_RECORDS);
+  LOG_DEBUG("Newest record: ");
+  LOG_DEBUGLN(newestRecord);
+  LOG_DEBUG("Phase: ");
+  LOG_DEBUGLN(phase >> 7);
+  for (uint8_t servoNr = 0; servoNr < NUMBER_OF_SERVOS; servoNr++) {
+    LOG_DEBUG("Servo"); 
+    LOG_DEBUG(servoNr);
+    LOG_DEBUG(" position: ");
+    LOG_DEBUGLN(servoPositions[servoNr]);
+  };
 };
@@ -5,6 +5,12 @@
 // History:   2025/02/13
 //            2025/03/22   ap indexPosition0 and indexPosition1 moved into an Array
 //            2025/06/01 ap: first production version 
+//            2026/10/16 agent: log-structured journal instead of a fixed slot per boot
+//            2026/10/16 agent: deferred writes, with a flush on power failure
+//            2026/10/16 agent: one bit per servo instead of one byte
+//            2026/10/16 agent: a torn write of the first slot does not lose the newest record
+//            2026/10/16 agent: records are written via the EEPROM write queue
+//            2026/10/16 agent: reload()
 // 
 // How to store the current switch / servo position(s) in EEPROM, in such way that the wear-out
 // gets reduced / EEPROM endurance gets improved. 
@@ -18,30 +24,54 @@
 // This is exactly the idea that we follow here. The key question, however, is how to know which 
 // cell in the circular buffer holds the switch position (thus holds an index into the buffer).  
 //
-// The core idea is to have a location in EEPROM, called numberOfBoots, that holds a pointer
-// to the cell(s) in the circular buffer that hold(s) the latest servo position(s). 
-// Every time the decoder starts (resets, power-up), the numberOfBoots gets incremented by one.
-// Once the decoder has started, the servo position(s) is(are) always written to the same  
-// byte(s) in the circular buffer. The assumption is that the decoder is started only once a day, 
-// but that during that day the servo(s) change their position many times. 
+// The circular buffer is used as a journal: a sequence of records, where each record holds the
+// positions of all servos. Every time a servo position is saved, a complete new record is written 
+// into the next slot of the circular buffer. Therefore every write goes to a different location, and
+// wear is spread over the complete buffer for every write (and not only once per boot). This is 
+// important for layouts that stay powered for weeks, and where switches change their positions
+// thousands of times.
 //
-// Below the basic algorithm in more detail.
-// At start-up, as part of setup(), the value of numberOfBoots is read from EEPROM, as well as the
-// contents of the circular buffer location(s) that numberOfBoots points to (the servo position).
-// NumberOfBoots gets updated after the first EEPROM write, thus after the first accessory command
-// that leads to a change in position of a servo. The idea to update numberOfBoots after the first
-// accessory command, and not as part of setup(), is to avoid unnecessary EEPROM writes in case the
-// decoder is powered on, but not being used for servo movements.
+// The curves (curve0 and curve1) of each servo are stored in its CVs. Therefore the only thing that
+// has to be stored is which of both curves was used last: the position (0 or 1) of the servo. This
+// takes a single bit per servo, thus a record is a single byte for up to 6 servos (and two bytes for
+// up to 14 servos). As a result, every command costs a single EEPROM byte write, and the circular 
+// buffer holds many more records than if a byte per servo were used.
 //
-// NumberOfBoots, and the circular buffer itself, will be stored at the end of the EEPROM space.
-// The file "hardware.h" defines SIZE_CIRCULAR_BUFFER as well as EEPROM_BOOTS_INDEX. These values
-// depend on the size of the EEPROM, and the number of supported servos for this board.
+// To find the newest record, each record carries a phase bit. All records written during one pass
+// through the circular buffer have the same phase; after the last slot we continue with the first
+// slot, and the phase flips. Erased EEPROM cells (0xFF) have bit 6 set, which is never set in a
+// valid record. At start-up the newest record is found by a single scan from the first slot: it is 
+// the last slot that holds a valid record with the same phase as the first slot. 
 //
-// If multiple servos are implemented, we store for each servo its positions.
-// The position for the first servo is stored at the index where the contents of EEPROM_BOOTS_INDEX 
-// points to. The subsequent servo position are stored in the bytes above.
-// 
-// Once the end of the circular buffer is reached, we continue at the start of the circular buffer.
+// A record is written as a single byte (for 6 servos or less). If power fails while this byte is
+// being written, the byte is either unchanged (old phase), or erased (bit 6 set). In both cases the 
+// start-up scan finds the previous (complete) record as the newest one. If this happens to the first
+// slot at the start of a new pass, the first slot is erased while the other slots still hold the 
+// records of the previous pass. The start-up scan then starts at the second slot, and finds the last
+// record of the previous pass as the newest one. For two byte records, byte 1 is written first and 
+// byte 0, which holds the phase, last.
+//
+// Record layout (POSITION_RECORD_SIZE bytes, see hardware.h):
+// Byte 0:   bit 7:    phase
+//           bit 6:    always 0 (1 = erased / no record)
+//           bit 0..5: position of servo 0..5
+// Byte 1:   bit 0..7: position of servo 6..13 (only if there are more than 6 servos)
+//
+// Deferred writes:
+// A new position is first stored in RAM only. The record is written to EEPROM by check(), which is
+// called from the main loop, once no new position has been requested for POSITION_WRITE_DELAY 
+// milliseconds. Toggling a turnout several times in a row therefore costs one EEPROM write instead of
+// many, and the (slow) EEPROM write is no longer part of the handling of a DCC command.
+// The risk is that positions are lost if the decoder loses power within this delay. To avoid this, 
+// the Voltage Level Monitor (VLM) of the AVR-DA may be used: if the supply voltage drops below the
+// VLM level (25% above the BOD level), an interrupt is raised and check() writes all unsaved positions
+// immediately. The capacitors on the board provide enough energy for a single record.
+// The bytes of a record are not written directly, but via the EEPROM write queue (see eeprom_writer.h),
+// so the main loop never waits for the EEPROM.
+//
+// The circular buffer is stored at the end of the EEPROM space. The file "hardware.h" defines 
+// START_INDEX_POSITIONS, SIZE_CIRCULAR_BUFFER and NUMBER_OF_POSITION_RECORDS. These values depend
+// on the size of the EEPROM, and the number of supported servos for this board.
 // 
 //******************************************************************************************************
 #pragma once
@@ -53,19 +83,25 @@ class ServoPosition {
   public:
     ServoPosition();                            // constructor
 
-    void saveServoPosition(uint8_t number, uint8_t value); // should be called after a change
-    uint16_t servoPositions[NUMBER_OF_SERVOS];  // Where are the various servo positions stored in EEPROM?
+    void saveServoPosition(uint8_t number, uint8_t value); // value = position (0/1) of the servo
+    void check();                               // Should be called from main as frequent as possible
+    void flush();                               // Writes unsaved positions immediately
+    void initPowerFailDetection();              // Enables the VLM interrupt. Called from setup()
+    void reload();                              // Should be called after the buffer was overwritten
+    uint8_t servoPositions[NUMBER_OF_SERVOS];   // The last stored position (0/1) of each servo
     
     void clearEEPROMCircularBufferValues();     // Can be called if the EEPROM gets (re)initialised
     void printEEPROM();                         // Only for testing
     
   private:
-    bool firstCall;                             // The processor just got powered up / reset / reflashed
-    void incrementNumberOfBoots();              // Will be called after the first servo position change
-    void calculateservoPositions();             // Use numberOfBoots to find servoPositions[]
-    uint16_t getIndex(uint8_t servoNumber);     // Calculate the storage position for a specific servo  
+    void findNewestRecord();                    // Start-up scan for the newest record
+    uint16_t getIndex(uint8_t record);          // EEPROM index of the first byte of a record
+    void writeRecord();                         // Writes all positions into the next record
 
-    uint8_t numberOfBoots;                      // 0 .. SIZE_CIRCULAR_BUFFER - 1
+    uint8_t newestRecord;                       // 0 .. NUMBER_OF_POSITION_RECORDS - 1
+    uint8_t phase;                              // Phase bit of the newest record (0x00 or 0x80)
+    bool unsaved;                               // RAM holds positions not yet stored in EEPROM
+    unsigned long lastChange;                   // Time (in ms) of the last position change
 };
 
 
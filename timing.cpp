@@ -0,0 +1,107 @@
+// *****************************************************************************************************
+//
+// File:      timing.cpp
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 Version 1.1 - Histograms per stage of the main loop
+//            2026/10/16 agent: SavePosition measures writeRecord()
+//            2026/10/16 agent: read-only CVs with the results of the last report
+//
+// Purpose:   Measure the execution time of the main parts of the decoder software
+//
+// See timing.h for an explanation and the list of items that are measured.
+//
+// *****************************************************************************************************
+#include "timing.h"
+#include "hardware.h"                       // For Monitor
+
+#if TIMING_ENABLED
+
+#if ((TIMING_CV_START + TIMING_CVS) > CURVE_LIBRARY_CV)
+  #error The timing CVs overlap with the command CVs of the curve library
+#endif
+
+// Instantiate the object for the timing measurements
+Timing timing;
+
+const char* const timedItemNames[CheckServo] = {
+  "Loop iteration",
+  "DCC dispatch",
+  "decoderHardware.update",
+  "checkRSFeedback",
+  "routes.check",
+  "Buttons",
+  "MyServo::set",
+  "writeRecord"
+};
+
+
+void Timing::record(uint8_t item, uint16_t duration) {
+  if (calls[item] < 0xFFFF) {               // Avoid overflow if the report is not called
+    calls[item]++;
+    total[item] += duration;
+  }
+  if (duration > longest[item]) longest[item] = duration;
+  // The bucket is the number of significant bits of the duration, limited to the last bucket
+  uint8_t bucket = 0;
+  while (duration) {
+    bucket++;
+    duration = duration >> 1;
+  };
+  if (bucket >= TIMING_BUCKETS) bucket = TIMING_BUCKETS - 1;
+  if (histogram[item][bucket] < 0xFFFF) histogram[item][bucket]++;
+}
+
+
+void Timing::report() {
+  pomFeedback.checkConnection();
+  if ((millis() - lastReport) < TIMING_REPORT_INTERVAL) return;
+  lastReport = millis();
+  Monitor.println();
+  Monitor.println("Timing (us) - calls / average / longest / histogram: 0, 1, 2-3, 4-7, .., >=1024");
+  for (uint8_t i = 0; i < NUMBER_OF_TIMED_ITEMS; i++) {
+    if (i < CheckServo) Monitor.print(timedItemNames[i]);
+    else {
+      Monitor.print("checkServo ");
+      Monitor.print(i - CheckServo);
+    }
+    Monitor.print(": ");
+    Monitor.print(calls[i]);
+    Monitor.print(" / ");
+    if (calls[i]) Monitor.print(total[i] / calls[i]);
+      else Monitor.print("-");
+    Monitor.print(" / ");
+    Monitor.print(longest[i]);
+    Monitor.print(" /");
+    // Keep a copy of the results, such that these can be read via PoM till the next report
+    uint8_t* cv = &reported[i * TIMING_CVS_PER_ITEM];
+    cv[0] = lowByte(calls[i]);
+    cv[1] = highByte(calls[i]);
+    cv[2] = lowByte(longest[i]);
+    cv[3] = highByte(longest[i]);
+    for (uint8_t bucket = 0; bucket < TIMING_BUCKETS; bucket++) {
+      Monitor.print(" ");
+      Monitor.print(histogram[i][bucket]);
+      cv[4 + 2 * bucket] = lowByte(histogram[i][bucket]);
+      cv[5 + 2 * bucket] = highByte(histogram[i][bucket]);
+      histogram[i][bucket] = 0;
+    }
+    Monitor.println();
+    calls[i] = 0;
+    total[i] = 0;
+    longest[i] = 0;
+  }
+}
+
+
+bool Timing::cvCommand(Dcc::CmdType_t cmdType) {
+  // The timing CVs are read-only. Only a PoM read gets an answer; all other commands are ignored.
+  if ((cvCmd.number < TIMING_CV_START) || (cvCmd.number >= (TIMING_CV_START + TIMING_CVS))) return false;
+  if ((cmdType == Dcc::MyPomCmd) && (cvCmd.operation == CvAccess::verifyByte)) {
+    pomFeedback.address = TIMING_POM_ADDRESS;
+    pomFeedback.send8bits(reported[cvCmd.number - TIMING_CV_START]);
+  }
+  return true;
+}
+
+#endif
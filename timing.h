@@ -0,0 +1,112 @@
+// *****************************************************************************************************
+//
+// File:      timing.h
+// Author:    agent
+// History:   2026/10/16 Version 1.0
+//            2026/10/16 Version 1.1 - Histograms per stage of the main loop
+//            2026/10/16 agent: SavePosition measures writeRecord()
+//            2026/10/16 agent: read-only CVs with the results of the last report
+//
+// Purpose:   Measure the execution time of the main parts of the decoder software
+//
+// The decoder software depends on the DxCore board definitions and the AP_DCC_Decoder_Core and
+// Servo-TCA libraries, and therefore only runs on the decoder board itself. To get an idea of the
+// costs of the various routines, without the need to use a scope, the sketch can measure these
+// costs itself. For that purpose set TIMING_ENABLED (below) to 1.
+//
+// The following items are measured:
+// - LoopIteration:  a complete pass through loop()
+// - DccDispatch:    dcc.input() plus the handling of the received DCC command
+// - DecoderUpdate:  decoderHardware.update()
+// - RsFeedback:     rsbus.checkRSFeedback()
+// - RouteCheck:     routes.check()
+// - Buttons:        reading all buttons (and acting upon a change)
+// - ServoSet:       from a new position till the servo starts moving
+// - SavePosition:   writing a position record into EEPROM (ServoPosition::writeRecord())
+// - CheckServo + i: checkServo() for servo i
+//
+// For each item the number of calls, the average and the longest duration (in us) are collected,
+// together with a histogram with logarithmic buckets. Bucket 0 counts durations of 0 us, bucket 1 of
+// 1 us, bucket 2 of 2..3 us, bucket 3 of 4..7 us etc. The last bucket counts all durations of 1024 us
+// and longer. Such histogram shows not only the average costs, but also how often a stage takes (much)
+// longer, and thus which stage is responsible for the long loops on a live layout.
+//
+// Every TIMING_REPORT_INTERVAL milliseconds the results are printed on the serial monitor, after which
+// the counters start again from zero. Measurements are based on micros(), which has a resolution of
+// 1 us if TCB2 is used for millis. Note that the measurement itself also costs a few microseconds, 
+// which are included in the results. If TIMING_ENABLED is 0, the macros below are empty and no code
+// or RAM is used at all.
+//
+// The results of the last report can also be read on a live layout, without a serial monitor, via
+// PoM. For that purpose they are available as read-only CVs, starting at TIMING_CV_START. Each item
+// takes TIMING_CVS_PER_ITEM CVs, in the order of the list above, with all 16 bit values low byte first:
+// - offset 0, 1:          number of calls
+// - offset 2, 3:          longest duration (in us)
+// - offset 4 + 2 * b, +1: histogram bucket b
+// For example, the longest checkServo() of servo 1 is in the CVs that start at
+// TIMING_CV_START + (CheckServo + 1) * TIMING_CVS_PER_ITEM + 2 (with 12 buckets: 700 + 9 * 28 + 2 = 954).
+// cvCommand() is called by main before the CV is handled by the library. It answers a PoM read via
+// RS-Bus address TIMING_POM_ADDRESS, and ignores writes and SM commands to these CVs.
+//
+// *****************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include <AP_DCC_Decoder_Core.h>           // For cvCmd
+#include <RSBus.h>                          // For the answers to PoM reads
+#include "hardware.h"                       // For NUMBER_OF_SERVOS
+
+#define TIMING_ENABLED             0     // 1 = measure and report / 0 = no timing code at all
+#define TIMING_REPORT_INTERVAL  5000     // Milliseconds between two reports on the serial monitor
+#define TIMING_BUCKETS            12     // Number of (logarithmic) histogram buckets
+#define TIMING_CV_START          700     // First read-only CV (the last is below CURVE_LIBRARY_CV)
+#define TIMING_POM_ADDRESS       128     // RS-Bus address for the answers to PoM reads
+
+
+#if TIMING_ENABLED
+
+typedef enum {
+  LoopIteration,
+  DccDispatch,
+  DecoderUpdate,
+  RsFeedback,
+  RouteCheck,
+  Buttons,
+  ServoSet,
+  SavePosition,
+  CheckServo,                                       // Followed by one item per servo
+  NUMBER_OF_TIMED_ITEMS = CheckServo + NUMBER_OF_SERVOS
+} TimedItem_t;
+
+#define TIMING_CVS_PER_ITEM      (4 + 2 * TIMING_BUCKETS)
+#define TIMING_CVS               (NUMBER_OF_TIMED_ITEMS * TIMING_CVS_PER_ITEM)
+
+
+class Timing {
+  public:
+    void record(uint8_t item, uint16_t duration);   // Adds one measurement (in us)
+    void report();                                  // Should be called from main as frequent as possible
+    bool cvCommand(Dcc::CmdType_t cmdType);         // true: cvCmd addresses one of the timing CVs
+
+  private:
+    uint16_t calls[NUMBER_OF_TIMED_ITEMS];          // Number of measurements since the last report
+    uint32_t total[NUMBER_OF_TIMED_ITEMS];          // Sum of all measurements (in us)
+    uint16_t longest[NUMBER_OF_TIMED_ITEMS];        // Longest measurement (in us)
+    uint16_t histogram[NUMBER_OF_TIMED_ITEMS][TIMING_BUCKETS];
+    unsigned long lastReport;                       // Time (in ms) of the last report
+    uint8_t reported[TIMING_CVS];                   // Results of the last report, as read-only CVs
+    RSbusConnection pomFeedback;                    // For the answers to PoM reads
+};
+
+extern Timing timing;
+
+#define TIMING_START(t)          uint16_t t = micros()
+#define TIMING_STOP(item, t)     timing.record(item, (uint16_t)micros() - t)
+#define TIMING_REPORT()          timing.report()
+
+#else
+
+#define TIMING_START(t)
+#define TIMING_STOP(item, t)
+#define TIMING_REPORT()
+
+#endif